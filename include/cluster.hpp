@@ -0,0 +1,40 @@
+#pragma once
+#include "runner.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+// Coordinated runs across processes/hosts. Agents and the coordinator talk
+// newline-delimited JSON over TCP ("host:port", "tcp:host:port") or a Unix
+// stream socket ("unix:/path"):
+//
+//   coordinator -> agent   {"type":"prepare","config":{...}}
+//   agent -> coordinator   {"type":"ready","hostname":...}   (workload initialised)
+//   coordinator -> agent   {"type":"start"}                   (sent once all agents are ready)
+//   agent -> coordinator   {"type":"interval",...}            (one per telemetry interval)
+//   agent -> coordinator   {"type":"result","result":{...}}   (same shape as --output JSON)
+//
+// Either side may send {"type":"error","message":...} and close the session.
+
+struct CoordinatorConfig {
+    // run.threads <= 0 leaves the thread count to each agent (its own core count).
+    RunConfig run;
+    std::vector<std::string> agents;
+    double outlier_threshold = 0.10;
+    int connect_timeout_seconds = 10;
+};
+
+// Serves coordinator sessions one at a time until the process is killed.
+int run_agent(const std::string& listen_address);
+
+// Runs cfg.run on every agent behind a start barrier and fills `report` with
+// the aggregate. Returns a process exit code.
+int run_coordinator(const CoordinatorConfig& cfg, nlohmann::json& report);
+
+// Merges per-host results ({"agent","hostname","result"}) into one report and
+// flags hosts whose throughput or p99 deviates from the median by more than
+// outlier_threshold (relative).
+nlohmann::json aggregate_host_results(const std::vector<nlohmann::json>& hosts, const RunConfig& cfg,
+                                      double outlier_threshold);
+
+void print_aggregate(const nlohmann::json& report);
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Log-linear latency histogram over integer values (nanoseconds). Every power
+// of two is split into 2^kSubBits linear buckets, so a recorded value is off by
+// at most ~3%. Histograms merge by adding bucket counts, which lets results
+// from separate threads, processes or hosts be combined exactly.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 5;
+
+    LatencyHistogram();
+
+    void record(uint64_t value);
+    void add_bucket(size_t index, uint64_t count);
+    void merge(const LatencyHistogram& other);
+    // Replaces the bucket-bound estimates add_bucket() leaves behind with the
+    // exact extremes, when those are known (e.g. exported alongside the buckets).
+    void set_bounds(uint64_t min, uint64_t max);
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+    double percentile(double p) const;
+
+    const std::vector<uint64_t>& buckets() const { return counts_; }
+
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_lower(size_t index);
+    static uint64_t bucket_upper(size_t index);
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+    // Exact when built by record(); estimated from bucket midpoints for
+    // counts added with add_bucket().
+    long double sum_ = 0;
+};
@@ -16,9 +16,20 @@ struct PerfCounters {
 };
 
 
+// Bits returned by perf_opened(). perf_create() succeeds if any one counter
+// opens; perf_read() returns 0 for the ones that did not.
+enum PerfCounterBits : unsigned {
+    PERF_HAS_INSTRUCTIONS = 1u << 0,
+    PERF_HAS_CYCLES = 1u << 1,
+    PERF_HAS_CACHE_REFERENCES = 1u << 2,
+    PERF_HAS_CACHE_MISSES = 1u << 3,
+    PERF_HAS_BRANCH_MISSES = 1u << 4,
+};
+
 struct PerfHandle;
 
 PerfHandle* perf_create();
+unsigned perf_opened(PerfHandle* h);
 void perf_reset(PerfHandle* h);
 void perf_enable(PerfHandle* h);
 void perf_disable(PerfHandle* h);
@@ -0,0 +1,63 @@
+#pragma once
+#include "workload.hpp"
+#include "stats.hpp"
+#include "histogram.hpp"
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct RunConfig {
+    std::string workload = "simd";
+    int duration_seconds = 10;
+    int threads = 1;
+    size_t workset_bytes = 128 * 1024 * 1024;
+    WorkloadParams params;
+    double interval_seconds = 1.0;
+    // Worker thread pinning: "none", "compact" (thread i on the i-th allowed
+    // CPU) or "spread" (threads evenly spaced over the allowed CPUs).
+    std::string placement = "none";
+};
+
+bool valid_placement(const std::string& placement);
+
+// Batches completed during one telemetry interval of a run.
+struct IntervalSample {
+    int index = 0;
+    double elapsed_seconds = 0.0;
+    uint64_t batches = 0;
+    double throughput_batches_per_s = 0.0;
+};
+
+struct RunResult {
+    uint64_t total_batches = 0;
+    double throughput = 0.0;
+    int score = 0;
+    Stats stats;
+    std::vector<double> samples;
+    LatencyHistogram histogram;
+    std::vector<IntervalSample> intervals;
+    nlohmann::json metrics = nlohmann::json::object();
+};
+
+int compact_score(double throughput);
+
+// Drives an already configured and initialised workload for cfg.duration_seconds
+// on cfg.threads threads, then collects its report(). The caller owns shutdown().
+// on_interval is called from the monitoring thread as each interval closes.
+// If run_batch() throws, the other workers stop and the first exception is
+// rethrown here once they have joined.
+RunResult run_workload(Workload& workload, const RunConfig& cfg, bool show_progress,
+                       const std::function<void(const IntervalSample&)>& on_interval = {});
+
+void print_result(const RunConfig& cfg, const RunResult& r);
+nlohmann::json result_to_json(const RunConfig& cfg, const RunResult& r);
+
+nlohmann::json histogram_to_json(const LatencyHistogram& h);
+LatencyHistogram histogram_from_json(const nlohmann::json& j);
+
+// Overwrites the fields of cfg present in j (duration, threads, workset_bytes,
+// workload, params, interval, placement); throws nlohmann::json::exception on
+// bad types and std::invalid_argument on an unknown placement.
+void apply_run_config(const nlohmann::json& j, RunConfig& cfg);
+nlohmann::json run_config_to_json(const RunConfig& cfg);
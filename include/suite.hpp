@@ -0,0 +1,38 @@
+#pragma once
+#include "runner.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+// Benchmark suites: one JSON file describing a sequence of stages, each of
+// which may sweep workload x workset_bytes x threads x placement (any of those
+// keys, and any key inside "params", may be an array). Top-level keys are
+// defaults for every stage:
+//
+//   {
+//     "duration": 10,
+//     "output": "suite.json",
+//     "stages": [
+//       {"name": "scaling", "workload": "simd", "threads": [1, 2, 4, 8], "placement": ["compact", "spread"]},
+//       {"name": "kernels", "workload": ["hashtable", "sort"], "threads": 8, "params": {"load_factor": 0.7}}
+//     ]
+//   }
+//
+// Runs execute in one process; a workload instance is kept across consecutive
+// runs when Workload::reuse() accepts the next shape, so its workset is not
+// re-allocated and re-faulted.
+
+struct SuiteRun {
+    std::string stage;
+    RunConfig cfg;
+};
+
+// Expands a suite document into its runs, in execution order. Throws
+// std::invalid_argument or nlohmann::json::exception on malformed input.
+std::vector<SuiteRun> expand_suite(const nlohmann::json& suite, const RunConfig& defaults);
+
+// Runs every stage of the suite file and writes one consolidated JSON report to
+// out_file (or the suite's "output"). A run that throws is recorded with an
+// "error" entry and the suite continues. Returns a process exit code, non-zero
+// if any run failed.
+int run_suite(const std::string& path, const RunConfig& defaults, const std::string& out_file);
@@ -1,3 +1,4 @@
+#pragma once
 #include <string>
 #include <vector>  
 
@@ -12,3 +13,16 @@
 double run_command(const std::string& cmd);
 void print_header();
 void print_results(const std::string& cmd, const std::vector<double>& times);
+
+// Peak resident set size of this process in KiB (0 where unsupported).
+long peak_rss_kb();
+// Best effort: restart peak RSS tracking so the next peak_rss_kb() covers only
+// what happens from now on (Linux /proc/self/clear_refs, needs kernel >= 4.0).
+void reset_peak_rss();
+
+// CPUs this process may run on (empty where unsupported).
+std::vector<int> allowed_cpus();
+// Pins the calling thread to one CPU; false if unsupported or refused.
+bool pin_current_thread(int cpu);
+// CPU the calling thread is running on, or -1.
+int current_cpu();
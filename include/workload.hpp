@@ -2,6 +2,13 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <nlohmann/json_fwd.hpp>
+
+using WorkloadParams = std::map<std::string, std::string>;
 
 class Workload {
 public:
@@ -10,6 +17,20 @@ public:
     virtual uint64_t run_batch() = 0;
     virtual void shutdown() = 0;
     virtual std::string name() const = 0;
+
+    // Optional: workload-specific knobs from --param key=value / config "params".
+    // Called before init(); throws std::invalid_argument on bad values.
+    virtual void configure(const WorkloadParams& params) { (void)params; }
+
+    // Optional: workload-specific results, written under "metrics" in the report.
+    // Called after all benchmark threads have joined and before shutdown();
+    // elapsed_seconds runs from the start of the run until the last worker joined.
+    virtual void report(nlohmann::json& out, double elapsed_seconds) const { (void)out; (void)elapsed_seconds; }
+
+    // Optional: lets a suite keep this instance, and the workset it allocated,
+    // for another run instead of shutdown() + init(). Return true only if the
+    // current state fits the new shape, after clearing per-run counters.
+    virtual bool reuse(int threads, size_t workset_bytes) { (void)threads; (void)workset_bytes; return false; }
 };
 
 class SIMDWorkload : public Workload {
@@ -18,10 +39,33 @@ public:
     uint64_t run_batch() override;
     void shutdown() override;
     std::string name() const override;
+    bool reuse(int threads, size_t workset_bytes) override;
 
 private:
     std::vector<float> data;
     uint64_t s = 0;
 };
 
+// Maps each thread calling run_batch() to a stable index in [0, n) so that
+// workloads can keep per-thread state without locking on the hot path. The
+// first call from a thread takes a lock; later calls hit a thread_local cache
+// that reset() invalidates by moving to a new generation.
+class ThreadSlots {
+public:
+    ThreadSlots();
+    void reset(int n);
+    int current();
+    int size() const { return n_; }
+
+private:
+    std::mutex mtx_;
+    std::map<std::thread::id, int> ids_;
+    int n_ = 1;
+    std::atomic<uint64_t> generation_;
+};
+
+std::string param_string(const WorkloadParams& p, const std::string& key, const std::string& def);
+double param_double(const WorkloadParams& p, const std::string& key, double def);
+uint64_t param_u64(const WorkloadParams& p, const std::string& key, uint64_t def);
+
 void register_builtin_workloads();
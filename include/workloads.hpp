@@ -1,2 +1,8 @@
 #pragma once
 void register_builtin_workloads();
+
+// Per-family registration, called from register_builtin_workloads().
+void register_alloc_workloads();
+void register_kernel_workloads();
+void register_jitter_workloads();
+void register_branch_workloads();
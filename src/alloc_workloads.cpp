@@ -0,0 +1,459 @@
+#include "workload.hpp"
+#include "workload_registry.hpp"
+#include "workloads.hpp"
+#include "stats.hpp"
+#include "utils.hpp"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+// Allocator stress workloads: alloc_malloc, alloc_pool and alloc_arena run the
+// same allocation pattern against the linked malloc, a thread-local pool and a
+// thread-local arena so the three can be compared like for like.
+//
+// Parameters (--param key=value):
+//   sizes=16:40,64:30,...  size:weight mix of request sizes in bytes
+//   long_lived=0.05        fraction of allocations kept in the long-lived ring
+//   retain=4096            long-lived ring length per thread
+//   short_window=16        short-lived ring length per thread
+//   remote_free=0.0        fraction of frees handed to the next thread (producer/consumer)
+//   batch_ops=4096         allocations per run_batch() call
+//   sample_every=64        time one in N allocations and frees
+//
+// A steady_clock::now() pair costs tens of ns, as much as a fast allocation,
+// so init() measures the empty interval once and every sample has it
+// subtracted (clamped at 0). The floor is reported as timer_overhead_ns.
+
+namespace {
+
+class Allocator {
+public:
+    virtual ~Allocator() = default;
+    // `slot` is the calling thread's slot; release() may run on a different
+    // slot than the allocate() that produced the block.
+    virtual void* allocate(int slot, size_t bytes) = 0;
+    virtual void release(int slot, void* p, size_t bytes) = 0;
+};
+
+class MallocAllocator : public Allocator {
+public:
+    void* allocate(int, size_t bytes) override { return std::malloc(bytes); }
+    void release(int, void* p, size_t) override { std::free(p); }
+};
+
+// Segregated power-of-two free lists (16 B .. 32 KiB) per thread, carved from
+// 256 KiB slabs. A remote free lands on the freeing thread's list, so blocks
+// migrate between threads instead of taking a lock.
+class PoolAllocator : public Allocator {
+public:
+    explicit PoolAllocator(int slots) : lists_(slots) {}
+    ~PoolAllocator() override { for (void* s : slabs_) std::free(s); }
+
+    void* allocate(int slot, size_t bytes) override {
+        if (bytes > kMaxBlock) return std::malloc(bytes);
+        size_t c = size_class(bytes);
+        FreeNode*& head = lists_[slot].heads[c];
+        if (!head) refill(slot, c);
+        FreeNode* n = head;
+        head = n->next;
+        return n;
+    }
+
+    void release(int slot, void* p, size_t bytes) override {
+        if (bytes > kMaxBlock) { std::free(p); return; }
+        FreeNode*& head = lists_[slot].heads[size_class(bytes)];
+        FreeNode* n = static_cast<FreeNode*>(p);
+        n->next = head;
+        head = n;
+    }
+
+private:
+    static constexpr size_t kMinShift = 4;
+    static constexpr size_t kMaxShift = 15;
+    static constexpr size_t kClasses = kMaxShift - kMinShift + 1;
+    static constexpr size_t kMaxBlock = size_t(1) << kMaxShift;
+    static constexpr size_t kSlabBytes = 256 * 1024;
+
+    struct FreeNode { FreeNode* next; };
+    struct alignas(64) SlotLists { FreeNode* heads[kClasses] = {}; };
+
+    static size_t size_class(size_t bytes) {
+        size_t shift = kMinShift;
+        while ((size_t(1) << shift) < bytes) ++shift;
+        return shift - kMinShift;
+    }
+
+    void refill(int slot, size_t c) {
+        char* slab = static_cast<char*>(std::malloc(kSlabBytes));
+        if (!slab) throw std::bad_alloc();
+        {
+            std::lock_guard<std::mutex> lk(slabs_mtx_);
+            slabs_.push_back(slab);
+        }
+        size_t block = size_t(1) << (c + kMinShift);
+        FreeNode* head = lists_[slot].heads[c];
+        for (size_t off = 0; off + block <= kSlabBytes; off += block) {
+            FreeNode* n = reinterpret_cast<FreeNode*>(slab + off);
+            n->next = head;
+            head = n;
+        }
+        lists_[slot].heads[c] = head;
+    }
+
+    std::vector<SlotLists> lists_;
+    std::mutex slabs_mtx_;
+    std::vector<void*> slabs_;
+};
+
+// Bump-pointer arenas over 1 MiB chunks, one current chunk per thread. Every
+// block is prefixed with its chunk; the owner holds one reference while the
+// chunk is current and whoever drops the last reference recycles the chunk
+// onto its own spare list.
+class ArenaAllocator : public Allocator {
+public:
+    explicit ArenaAllocator(int slots) : slots_(slots) {}
+    ~ArenaAllocator() override { for (void* c : chunks_) std::free(c); }
+
+    void* allocate(int slot, size_t bytes) override {
+        size_t need = kBlockHeader + ((bytes + 15) & ~size_t(15));
+        if (need > kCapacity / 4) {
+            char* raw = static_cast<char*>(std::malloc(need));
+            if (!raw) throw std::bad_alloc();
+            *reinterpret_cast<Chunk**>(raw) = nullptr;
+            return raw + kBlockHeader;
+        }
+        SlotState& s = slots_[slot];
+        if (!s.current || s.current->used + need > kCapacity) {
+            if (s.current) drop(slot, s.current);
+            s.current = take_chunk(slot);
+        }
+        Chunk* c = s.current;
+        char* raw = c->data() + c->used;
+        c->used += need;
+        c->live.fetch_add(1, std::memory_order_relaxed);
+        *reinterpret_cast<Chunk**>(raw) = c;
+        return raw + kBlockHeader;
+    }
+
+    void release(int slot, void* p, size_t) override {
+        char* raw = static_cast<char*>(p) - kBlockHeader;
+        Chunk* c = *reinterpret_cast<Chunk**>(raw);
+        if (!c) { std::free(raw); return; }
+        drop(slot, c);
+    }
+
+private:
+    static constexpr size_t kChunkBytes = 1024 * 1024;
+    static constexpr size_t kChunkHeader = 64;
+    static constexpr size_t kCapacity = kChunkBytes - kChunkHeader;
+    static constexpr size_t kBlockHeader = 16;
+
+    struct Chunk {
+        std::atomic<uint64_t> live{0};
+        size_t used = 0;
+        char* data() { return reinterpret_cast<char*>(this) + kChunkHeader; }
+    };
+    struct alignas(64) SlotState {
+        Chunk* current = nullptr;
+        std::vector<Chunk*> spare;
+    };
+
+    void drop(int slot, Chunk* c) {
+        if (c->live.fetch_sub(1, std::memory_order_acq_rel) == 1) slots_[slot].spare.push_back(c);
+    }
+
+    Chunk* take_chunk(int slot) {
+        auto& spare = slots_[slot].spare;
+        Chunk* c;
+        if (!spare.empty()) {
+            c = spare.back();
+            spare.pop_back();
+        } else {
+            void* mem = std::malloc(kChunkBytes);
+            if (!mem) throw std::bad_alloc();
+            {
+                std::lock_guard<std::mutex> lk(chunks_mtx_);
+                chunks_.push_back(mem);
+            }
+            c = new (mem) Chunk();
+        }
+        c->used = 0;
+        c->live.store(1, std::memory_order_relaxed);
+        return c;
+    }
+
+    std::vector<SlotState> slots_;
+    std::mutex chunks_mtx_;
+    std::vector<void*> chunks_;
+};
+
+std::vector<std::pair<size_t, double>> parse_size_mix(const std::string& spec) {
+    std::vector<std::pair<size_t, double>> mix;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        auto colon = item.find(':');
+        try {
+            size_t bytes = std::stoull(item.substr(0, colon));
+            double weight = colon == std::string::npos ? 1.0 : std::stod(item.substr(colon + 1));
+            if (bytes == 0 || weight < 0) throw std::invalid_argument(item);
+            mix.emplace_back(bytes, weight);
+        } catch (std::exception&) {
+            throw std::invalid_argument("bad size mix entry '" + item + "' (expected bytes:weight)");
+        }
+    }
+    if (mix.empty()) throw std::invalid_argument("size mix is empty");
+    return mix;
+}
+
+class AllocWorkload : public Workload {
+public:
+    enum class Kind { Malloc, Pool, Arena };
+
+    explicit AllocWorkload(Kind kind) : kind_(kind) {}
+
+    void configure(const WorkloadParams& p) override {
+        auto mix = parse_size_mix(param_string(p, "sizes", "16:40,32:20,64:15,128:10,256:8,1024:5,8192:2"));
+        if (mix.size() > 256) throw std::invalid_argument("size mix supports at most 256 entries");
+        long_lived_ = param_double(p, "long_lived", 0.05);
+        remote_free_ = param_double(p, "remote_free", 0.0);
+        retain_ = param_u64(p, "retain", 4096);
+        short_window_ = param_u64(p, "short_window", 16);
+        batch_ops_ = param_u64(p, "batch_ops", 4096);
+        sample_every_ = param_u64(p, "sample_every", 64);
+        if (long_lived_ < 0 || long_lived_ > 1 || remote_free_ < 0 || remote_free_ > 1)
+            throw std::invalid_argument("long_lived and remote_free must be in [0, 1]");
+        if (retain_ == 0 || short_window_ == 0 || batch_ops_ == 0 || sample_every_ == 0)
+            throw std::invalid_argument("retain, short_window, batch_ops and sample_every must be > 0");
+
+        // 256-entry lookup table so picking a size costs one load per allocation.
+        double total = 0;
+        for (auto& m : mix) total += m.second;
+        if (total <= 0) throw std::invalid_argument("size mix weights sum to zero");
+        sizes_.clear();
+        size_table_.clear();
+        double acc = 0;
+        for (auto& m : mix) {
+            sizes_.push_back(m.first);
+            acc += m.second;
+            size_t upto = static_cast<size_t>(acc / total * 256.0 + 0.5);
+            while (size_table_.size() < upto) size_table_.push_back(static_cast<uint8_t>(sizes_.size() - 1));
+        }
+        while (size_table_.size() < 256) size_table_.push_back(static_cast<uint8_t>(sizes_.size() - 1));
+    }
+
+    void init(int threads, size_t /*workset_bytes*/) override {
+        if (sizes_.empty()) configure({});
+        slots_.reset(threads);
+        int n = slots_.size();
+        switch (kind_) {
+        case Kind::Malloc: alloc_ = std::make_unique<MallocAllocator>(); break;
+        case Kind::Pool: alloc_ = std::make_unique<PoolAllocator>(n); break;
+        case Kind::Arena: alloc_ = std::make_unique<ArenaAllocator>(n); break;
+        }
+        threads_.clear();
+        for (int i = 0; i < n; ++i) {
+            auto t = std::make_unique<ThreadState>();
+            t->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+            t->short_ring.assign(short_window_, Block{});
+            t->long_ring.assign(retain_, Block{});
+            threads_.push_back(std::move(t));
+        }
+        timer_overhead_ns_ = measure_timer_overhead();
+        reset_peak_rss();
+    }
+
+    uint64_t run_batch() override {
+        int slot = slots_.current();
+        ThreadState& t = *threads_[slot];
+        drain_inbox(slot, t);
+        for (uint64_t i = 0; i < batch_ops_; ++i) {
+            size_t bytes = sizes_[size_table_[next(t.rng) & 255]];
+            bool sample = t.allocs % sample_every_ == 0;
+            void* p;
+            if (sample) {
+                auto s0 = std::chrono::steady_clock::now();
+                p = alloc_->allocate(slot, bytes);
+                auto s1 = std::chrono::steady_clock::now();
+                record(t.alloc_ns, t.allocs / sample_every_, net_ns(s0, s1));
+            } else {
+                p = alloc_->allocate(slot, bytes);
+            }
+            if (!p) throw std::bad_alloc();
+            static_cast<volatile char*>(p)[0] = 1;
+            ++t.allocs;
+
+            bool is_long = uniform(t.rng) < long_lived_;
+            auto& ring = is_long ? t.long_ring : t.short_ring;
+            size_t& pos = is_long ? t.long_pos : t.short_pos;
+            Block old = ring[pos];
+            ring[pos] = Block{p, bytes};
+            pos = (pos + 1) % ring.size();
+            if (old.p) dispose(slot, t, old, sample);
+        }
+        return batch_ops_;
+    }
+
+    void shutdown() override {
+        for (size_t i = 0; i < threads_.size(); ++i) {
+            ThreadState& t = *threads_[i];
+            drain_inbox(static_cast<int>(i), t);
+            for (auto& b : t.short_ring) if (b.p) alloc_->release(static_cast<int>(i), b.p, b.bytes);
+            for (auto& b : t.long_ring) if (b.p) alloc_->release(static_cast<int>(i), b.p, b.bytes);
+        }
+        threads_.clear();
+        alloc_.reset();
+    }
+
+    std::string name() const override {
+        switch (kind_) {
+        case Kind::Pool: return "alloc_pool";
+        case Kind::Arena: return "alloc_arena";
+        default: return "alloc_malloc";
+        }
+    }
+
+    void report(nlohmann::json& out, double elapsed_seconds) const override {
+        uint64_t allocs = 0, remote = 0;
+        std::vector<double> alloc_ns, free_ns;
+        for (auto& t : threads_) {
+            allocs += t->allocs;
+            remote += t->remote_frees;
+            alloc_ns.insert(alloc_ns.end(), t->alloc_ns.begin(), t->alloc_ns.end());
+            free_ns.insert(free_ns.end(), t->free_ns.begin(), t->free_ns.end());
+        }
+        auto latency = [](const std::vector<double>& v) {
+            nlohmann::json j;
+            Stats st = compute_stats(v, {50, 90, 99});
+            j["p50"] = st.percentiles[50];
+            j["p90"] = st.percentiles[90];
+            j["p99"] = st.percentiles[99];
+            j["p99.9"] = percentile(v, 99.9);
+            j["max"] = st.max;
+            return j;
+        };
+        out["allocator"] = name().substr(6);
+        out["allocs"] = allocs;
+        out["ops_per_s"] = elapsed_seconds > 0 ? allocs / elapsed_seconds : 0.0;
+        out["remote_frees"] = remote;
+        out["timer_overhead_ns"] = timer_overhead_ns_;
+        out["alloc_latency_ns"] = latency(alloc_ns);
+        out["free_latency_ns"] = latency(free_ns);
+        out["peak_rss_kb"] = peak_rss_kb();
+    }
+
+private:
+    struct Block { void* p = nullptr; size_t bytes = 0; };
+
+    struct ThreadState {
+        uint64_t rng = 0;
+        std::vector<Block> short_ring, long_ring;
+        size_t short_pos = 0, long_pos = 0;
+        uint64_t allocs = 0, frees = 0, remote_frees = 0;
+        std::vector<double> alloc_ns, free_ns;
+        std::mutex inbox_mtx;
+        std::vector<Block> inbox;
+    };
+
+    static constexpr size_t kMaxSamples = 1 << 16;
+    static constexpr size_t kMaxInbox = 1 << 16;
+
+    static uint64_t next(uint64_t& s) {
+        s ^= s >> 12; s ^= s << 25; s ^= s >> 27;
+        return s * 0x2545F4914F6CDD1Dull;
+    }
+    static double uniform(uint64_t& s) { return (next(s) >> 11) * (1.0 / 9007199254740992.0); }
+
+    // Median of many empty now()/now() intervals: the timer's floor.
+    static double measure_timer_overhead() {
+        std::vector<double> v(4096);
+        for (auto& x : v) {
+            auto s0 = std::chrono::steady_clock::now();
+            auto s1 = std::chrono::steady_clock::now();
+            x = std::chrono::duration<double, std::nano>(s1 - s0).count();
+        }
+        return median(v);
+    }
+
+    double net_ns(std::chrono::steady_clock::time_point s0, std::chrono::steady_clock::time_point s1) const {
+        double ns = std::chrono::duration<double, std::nano>(s1 - s0).count() - timer_overhead_ns_;
+        return ns > 0 ? ns : 0.0;
+    }
+
+    static void record(std::vector<double>& v, uint64_t n, double ns) {
+        if (v.size() < kMaxSamples) v.push_back(ns);
+        else v[n % kMaxSamples] = ns;
+    }
+
+    void dispose(int slot, ThreadState& t, const Block& b, bool sample) {
+        int n = static_cast<int>(threads_.size());
+        if (n > 1 && remote_free_ > 0 && uniform(t.rng) < remote_free_) {
+            ThreadState& peer = *threads_[(slot + 1) % n];
+            std::lock_guard<std::mutex> lk(peer.inbox_mtx);
+            if (peer.inbox.size() < kMaxInbox) {
+                peer.inbox.push_back(b);
+                ++t.remote_frees;
+                return;
+            }
+        }
+        release(slot, t, b, sample);
+    }
+
+    void release(int slot, ThreadState& t, const Block& b, bool sample) {
+        if (sample) {
+            auto s0 = std::chrono::steady_clock::now();
+            alloc_->release(slot, b.p, b.bytes);
+            auto s1 = std::chrono::steady_clock::now();
+            record(t.free_ns, t.frees / sample_every_, net_ns(s0, s1));
+        } else {
+            alloc_->release(slot, b.p, b.bytes);
+        }
+        ++t.frees;
+    }
+
+    // Consumer side of the producer/consumer pattern: free what the previous
+    // thread handed over.
+    void drain_inbox(int slot, ThreadState& t) {
+        std::vector<Block> pending;
+        {
+            std::lock_guard<std::mutex> lk(t.inbox_mtx);
+            pending.swap(t.inbox);
+        }
+        for (auto& b : pending) release(slot, t, b, t.frees % sample_every_ == 0);
+    }
+
+    Kind kind_;
+    std::unique_ptr<Allocator> alloc_;
+    ThreadSlots slots_;
+    std::vector<std::unique_ptr<ThreadState>> threads_;
+    std::vector<size_t> sizes_;
+    std::vector<uint8_t> size_table_;
+    double long_lived_ = 0.05;
+    double remote_free_ = 0.0;
+    uint64_t retain_ = 4096;
+    uint64_t short_window_ = 16;
+    uint64_t batch_ops_ = 4096;
+    uint64_t sample_every_ = 64;
+    double timer_overhead_ns_ = 0.0;
+};
+
+} // namespace
+
+void register_alloc_workloads() {
+    auto &reg = WorkloadRegistry::instance();
+    reg.register_factory("alloc_malloc", []() -> std::unique_ptr<Workload> {
+        return std::make_unique<AllocWorkload>(AllocWorkload::Kind::Malloc);
+    });
+    reg.register_factory("alloc_pool", []() -> std::unique_ptr<Workload> {
+        return std::make_unique<AllocWorkload>(AllocWorkload::Kind::Pool);
+    });
+    reg.register_factory("alloc_arena", []() -> std::unique_ptr<Workload> {
+        return std::make_unique<AllocWorkload>(AllocWorkload::Kind::Arena);
+    });
+}
@@ -0,0 +1,224 @@
+#include "workload.hpp"
+#include "workload_registry.hpp"
+#include "workloads.hpp"
+#include "perf_wrapper.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Branch predictability workload. A data array decides, element by element,
+// which way one conditional branch goes (or which of n functions an indirect
+// call reaches), so the predictability of the branch is exactly the entropy of
+// the data:
+//
+//   pattern=always            branch always taken
+//   pattern=periodic k=8      a random taken/not-taken pattern of length k, repeated
+//   pattern=random p=0.5      taken with probability p, independently
+//   pattern=indirect n=16     indirect call over n targets (k=0: uniform random
+//                             target, k>0: random target sequence of length k, repeated)
+//
+//   length=1048576            elements per batch (keep well above predictor history)
+//
+// Reports ns per branch and, for each perf counter that opened on every
+// thread, mispredicts, cycles and instructions per branch.
+
+namespace {
+
+constexpr int kMaxTargets = 256;
+
+// Keeps the compiler from if-converting the conditional branch into a cmov,
+// which would make the data pattern irrelevant.
+inline void branch_barrier() { std::atomic_signal_fence(std::memory_order_seq_cst); }
+
+template <int I>
+uint64_t dispatch_target(uint64_t x) {
+    return (x ^ (x >> 7)) * (2 * I + 1) + I;
+}
+
+using TargetFn = uint64_t (*)(uint64_t);
+
+template <size_t... I>
+constexpr std::array<TargetFn, sizeof...(I)> make_targets(std::index_sequence<I...>) {
+    return {{&dispatch_target<static_cast<int>(I)>...}};
+}
+
+const std::array<TargetFn, kMaxTargets> kTargets = make_targets(std::make_index_sequence<kMaxTargets>{});
+
+class BranchWorkload : public Workload {
+public:
+    void configure(const WorkloadParams& p) override {
+        pattern_ = param_string(p, "pattern", "random");
+        probability_ = param_double(p, "p", 0.5);
+        period_ = param_u64(p, "k", pattern_ == "periodic" ? 8 : 0);
+        targets_ = param_u64(p, "n", 16);
+        length_ = param_u64(p, "length", 1 << 20);
+        if (pattern_ != "always" && pattern_ != "periodic" && pattern_ != "random" && pattern_ != "indirect")
+            throw std::invalid_argument("pattern must be always, periodic, random or indirect");
+        if (probability_ < 0 || probability_ > 1) throw std::invalid_argument("p must be in [0, 1]");
+        if (pattern_ == "periodic" && period_ == 0) throw std::invalid_argument("k must be > 0 for periodic");
+        if (targets_ == 0 || targets_ > kMaxTargets) throw std::invalid_argument("n must be in [1, 256]");
+        if (length_ == 0) throw std::invalid_argument("length must be > 0");
+    }
+
+    void init(int threads, size_t /*workset_bytes*/) override {
+        uint64_t seed = 0xB4A2C4ull;
+        auto next = [&]() {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        };
+        auto uniform = [&]() { return (next() >> 11) * (1.0 / 9007199254740992.0); };
+
+        data_.assign(length_, 0);
+        if (pattern_ == "always") {
+            std::fill(data_.begin(), data_.end(), 1);
+        } else if (pattern_ == "random") {
+            for (auto& d : data_) d = uniform() < probability_ ? 1 : 0;
+        } else {
+            uint64_t values = pattern_ == "indirect" ? targets_ : 2;
+            if (period_ > 0) {
+                std::vector<uint8_t> cycle(period_);
+                for (auto& c : cycle) c = static_cast<uint8_t>(next() % values);
+                for (size_t i = 0; i < data_.size(); ++i) data_[i] = cycle[i % period_];
+            } else {
+                for (auto& d : data_) d = static_cast<uint8_t>(next() % values);
+            }
+        }
+
+        reset_threads(threads);
+    }
+
+    // The pattern does not depend on the workset, so any shape can reuse it.
+    // Perf handles count the thread that opened them and a new run brings new
+    // threads, so those are always reopened.
+    bool reuse(int threads, size_t /*workset_bytes*/) override {
+        reset_threads(threads);
+        return true;
+    }
+
+    uint64_t run_batch() override {
+        ThreadState& t = *threads_[slots_.current()];
+        if (!t.perf_attempted) {
+            t.perf = perf_create();
+            t.perf_opened = perf_opened(t.perf);
+            t.perf_attempted = true;
+        }
+
+        const uint8_t* d = data_.data();
+        size_t n = data_.size();
+        uint64_t acc = t.sink;
+        if (t.perf) { perf_reset(t.perf); perf_enable(t.perf); }
+        auto s0 = std::chrono::steady_clock::now();
+        if (pattern_ == "indirect") {
+            for (size_t i = 0; i < n; ++i) acc = kTargets[d[i]](acc);
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                if (d[i]) {
+                    branch_barrier();
+                    acc += i;
+                } else {
+                    branch_barrier();
+                    acc ^= i;
+                }
+            }
+        }
+        auto s1 = std::chrono::steady_clock::now();
+        if (t.perf) {
+            perf_disable(t.perf);
+            PerfCounters c = perf_read(t.perf);
+            t.cycles += c.cycles;
+            t.instructions += c.instructions;
+            t.branch_misses += c.branch_misses;
+        }
+        t.busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(s1 - s0).count();
+        t.branches += n;
+        t.sink = acc;
+        return n;
+    }
+
+    void shutdown() override {
+        reset_threads(0);
+        data_.clear();
+    }
+
+    std::string name() const override { return "branch"; }
+
+    void report(nlohmann::json& out, double elapsed_seconds) const override {
+        uint64_t branches = 0, busy_ns = 0, cycles = 0, instructions = 0, misses = 0;
+        // A counter is only usable if every thread that ran managed to open it;
+        // perf_read() reports 0 for the rest, which would read as "no misses".
+        unsigned opened = ~0u;
+        bool ran = false;
+        for (auto& t : threads_) {
+            branches += t->branches;
+            busy_ns += t->busy_ns;
+            cycles += t->cycles;
+            instructions += t->instructions;
+            misses += t->branch_misses;
+            if (t->perf_attempted) {
+                opened &= t->perf_opened;
+                ran = true;
+            }
+        }
+        if (!ran) opened = 0;
+        bool perf = (opened & PERF_HAS_BRANCH_MISSES) != 0;
+        double rate = elapsed_seconds > 0 ? branches / elapsed_seconds : 0.0;
+        out["pattern"] = pattern_;
+        if (pattern_ == "random") out["p"] = probability_;
+        if (pattern_ == "periodic" || pattern_ == "indirect") out["k"] = period_;
+        if (pattern_ == "indirect") out["n"] = targets_;
+        out["branches"] = branches;
+        out["ns_per_branch"] = branches ? static_cast<double>(busy_ns) / branches : 0.0;
+        out["perf"] = perf;
+        if (branches) {
+            if (perf) out["mispredict_rate"] = static_cast<double>(misses) / branches;
+            if (opened & PERF_HAS_CYCLES) out["cycles_per_branch"] = static_cast<double>(cycles) / branches;
+            if (opened & PERF_HAS_INSTRUCTIONS) out["instructions_per_branch"] = static_cast<double>(instructions) / branches;
+        }
+        out["branches_per_s"] = rate;
+        out["throughput"] = rate;
+        out["throughput_unit"] = "branches/s";
+    }
+
+private:
+    struct ThreadState {
+        PerfHandle* perf = nullptr;
+        unsigned perf_opened = 0;
+        bool perf_attempted = false;
+        uint64_t branches = 0, busy_ns = 0, cycles = 0, instructions = 0, branch_misses = 0;
+        uint64_t sink = 0;
+    };
+
+    void reset_threads(int threads) {
+        for (auto& t : threads_) perf_destroy(t->perf);
+        threads_.clear();
+        if (threads <= 0) return;
+        slots_.reset(threads);
+        for (int i = 0; i < slots_.size(); ++i) threads_.push_back(std::make_unique<ThreadState>());
+    }
+
+    ThreadSlots slots_;
+    std::vector<std::unique_ptr<ThreadState>> threads_;
+    std::vector<uint8_t> data_;
+    std::string pattern_ = "random";
+    double probability_ = 0.5;
+    uint64_t period_ = 0;
+    uint64_t targets_ = 16;
+    uint64_t length_ = 1 << 20;
+};
+
+} // namespace
+
+void register_branch_workloads() {
+    WorkloadRegistry::instance().register_factory("branch", []() -> std::unique_ptr<Workload> {
+        return std::make_unique<BranchWorkload>();
+    });
+}
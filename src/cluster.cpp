@@ -0,0 +1,549 @@
+#include "cluster.hpp"
+#include "workload_registry.hpp"
+#include "stats.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+
+#ifndef _WIN32
+#include <csignal>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+double relative_deviation(double v, double ref) {
+    if (ref == 0.0) return 0.0;
+    return (v - ref) / ref;
+}
+
+double host_p99_ms(const nlohmann::json& result) {
+    if (!result.contains("latency_histogram")) return 0.0;
+    return histogram_from_json(result["latency_histogram"]).percentile(99) / 1e6;
+}
+
+} // namespace
+
+nlohmann::json aggregate_host_results(const std::vector<nlohmann::json>& hosts, const RunConfig& cfg,
+                                      double outlier_threshold) {
+    nlohmann::json report;
+    report["mode"] = "coordinated";
+    report["workload"] = cfg.workload;
+    // threads <= 0: every agent ran with its own core count, see hosts[].threads.
+    if (cfg.threads > 0) report["threads_per_agent"] = cfg.threads;
+    report["duration_seconds"] = cfg.duration_seconds;
+    report["agents"] = hosts.size();
+    if (!cfg.params.empty()) report["params"] = cfg.params;
+
+    uint64_t total_batches = 0;
+    double throughput = 0.0;
+    LatencyHistogram merged;
+    std::map<int, double> interval_sum;
+    std::map<int, int> interval_hosts;
+    std::vector<double> host_throughput, host_p99;
+    std::string unit;
+    double unit_sum = 0.0;
+    bool unit_consistent = true;
+
+    for (auto& h : hosts) {
+        const auto& r = h["result"];
+        total_batches += r.value("total_batches", uint64_t(0));
+        double t = r.value("throughput_batches_per_s", 0.0);
+        throughput += t;
+        host_throughput.push_back(t);
+        host_p99.push_back(host_p99_ms(r));
+        if (r.contains("latency_histogram")) merged.merge(histogram_from_json(r["latency_histogram"]));
+        if (r.contains("intervals")) {
+            for (auto& s : r["intervals"]) {
+                int idx = s.value("index", 0);
+                interval_sum[idx] += s.value("throughput_batches_per_s", 0.0);
+                interval_hosts[idx]++;
+            }
+        }
+        const auto metrics = r.value("metrics", nlohmann::json::object());
+        if (metrics.contains("throughput_unit")) {
+            std::string u = metrics["throughput_unit"].get<std::string>();
+            if (unit.empty()) unit = u;
+            unit_consistent = unit_consistent && u == unit;
+            unit_sum += metrics.value("throughput", 0.0);
+        } else {
+            unit_consistent = false;
+        }
+    }
+
+    report["total_batches"] = total_batches;
+    report["throughput_batches_per_s"] = throughput;
+    report["score"] = compact_score(throughput);
+    if (unit_consistent && !unit.empty()) {
+        report["metrics"] = {{"throughput", unit_sum}, {"throughput_unit", unit}};
+    }
+
+    nlohmann::json jstats;
+    jstats["mean_ms"] = merged.mean() / 1e6;
+    jstats["min_ms"] = merged.min() / 1e6;
+    jstats["max_ms"] = merged.max() / 1e6;
+    nlohmann::json jperc;
+    for (int p : {50, 90, 99}) jperc[std::to_string(p)] = merged.percentile(p) / 1e6;
+    jperc["99.9"] = merged.percentile(99.9) / 1e6;
+    jstats["percentiles"] = jperc;
+    report["stats"] = jstats;
+    report["latency_histogram"] = histogram_to_json(merged);
+
+    // Only intervals every agent reported are comparable cluster-wide.
+    nlohmann::json jint = nlohmann::json::array();
+    for (auto& kv : interval_sum) {
+        if (interval_hosts[kv.first] != static_cast<int>(hosts.size())) continue;
+        jint.push_back({{"index", kv.first}, {"throughput_batches_per_s", kv.second}});
+    }
+    report["intervals"] = jint;
+
+    double median_t = host_throughput.empty() ? 0.0 : median(host_throughput);
+    double median_p99 = host_p99.empty() ? 0.0 : median(host_p99);
+    report["median_host_throughput_batches_per_s"] = median_t;
+    report["median_host_p99_ms"] = median_p99;
+    report["outlier_threshold"] = outlier_threshold;
+
+    nlohmann::json jhosts = nlohmann::json::array();
+    nlohmann::json outliers = nlohmann::json::array();
+    for (size_t i = 0; i < hosts.size(); ++i) {
+        double dev_t = relative_deviation(host_throughput[i], median_t);
+        double dev_p = relative_deviation(host_p99[i], median_p99);
+        bool t_out = std::fabs(dev_t) > outlier_threshold;
+        bool p_out = dev_p > outlier_threshold;
+        nlohmann::json jh;
+        jh["agent"] = hosts[i].value("agent", "");
+        jh["hostname"] = hosts[i].value("hostname", "");
+        jh["threads"] = hosts[i]["result"].value("threads", 0);
+        jh["throughput_batches_per_s"] = host_throughput[i];
+        jh["throughput_deviation"] = dev_t;
+        jh["p99_ms"] = host_p99[i];
+        jh["p99_deviation"] = dev_p;
+        jh["throughput_outlier"] = t_out;
+        jh["latency_outlier"] = p_out;
+        jh["outlier"] = t_out || p_out;
+        jh["result"] = hosts[i]["result"];
+        if (t_out || p_out) outliers.push_back(jh["agent"]);
+        jhosts.push_back(jh);
+    }
+    report["hosts"] = jhosts;
+    report["outliers"] = outliers;
+    return report;
+}
+
+void print_aggregate(const nlohmann::json& report) {
+    std::cout << "Workload: " << report.value("workload", "") << std::endl;
+    if (report.contains("threads_per_agent"))
+        std::cout << "Agents: " << report.value("agents", 0) << " x " << report["threads_per_agent"].get<int>() << " threads" << std::endl;
+    else
+        std::cout << "Agents: " << report.value("agents", 0) << " (threads: each agent's core count)" << std::endl;
+    std::cout << "Total Time: " << report.value("duration_seconds", 0) << "s" << std::endl;
+    std::cout << "Total Batches: " << report.value("total_batches", uint64_t(0)) << std::endl;
+    if (report.contains("metrics")) {
+        std::cout << "Throughput (" << report["metrics"]["throughput_unit"].get<std::string>() << "): " << std::fixed << std::setprecision(3) << report["metrics"]["throughput"].get<double>() << std::endl;
+    }
+    std::cout << "Throughput (batches/s): " << std::fixed << std::setprecision(3) << report.value("throughput_batches_per_s", 0.0) << std::endl;
+    std::cout << "Score: " << report.value("score", 0) << " (compact)" << std::endl;
+    const auto& perc = report["stats"]["percentiles"];
+    std::cout << "Merged latency (ms) p50: " << perc["50"].get<double>() << " p90: " << perc["90"].get<double>()
+              << " p99: " << perc["99"].get<double>() << " p99.9: " << perc["99.9"].get<double>() << "\n";
+    std::cout << "Per host:" << "\n";
+    for (auto& h : report["hosts"]) {
+        std::cout << "  " << (h["outlier"].get<bool>() ? "! " : "  ") << h["agent"].get<std::string>()
+                  << " (" << h["hostname"].get<std::string>() << ", " << h.value("threads", 0) << " threads)"
+                  << " batches/s: " << h["throughput_batches_per_s"].get<double>()
+                  << " (" << std::showpos << h["throughput_deviation"].get<double>() * 100.0 << "%" << std::noshowpos << ")"
+                  << " p99 ms: " << h["p99_ms"].get<double>() << "\n";
+    }
+    if (!report["outliers"].empty()) {
+        std::cout << report["outliers"].size() << " outlier host(s) deviate more than "
+                  << report["outlier_threshold"].get<double>() * 100.0 << "% from the median" << "\n";
+    }
+}
+
+#ifndef _WIN32
+
+namespace {
+
+struct Address {
+    bool is_unix = false;
+    std::string path;
+    std::string host;
+    std::string port;
+};
+
+bool parse_address(const std::string& s, Address& a) {
+    if (s.compare(0, 5, "unix:") == 0) {
+        a.is_unix = true;
+        a.path = s.substr(5);
+        return !a.path.empty() && a.path.size() < sizeof(sockaddr_un::sun_path);
+    }
+    std::string rest = s.compare(0, 4, "tcp:") == 0 ? s.substr(4) : s;
+    auto colon = rest.rfind(':');
+    if (colon == std::string::npos || colon + 1 == rest.size()) return false;
+    a.host = rest.substr(0, colon);
+    a.port = rest.substr(colon + 1);
+    return true;
+}
+
+int open_socket(const Address& a, bool listening) {
+    if (a.is_unix) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        sockaddr_un sa{};
+        sa.sun_family = AF_UNIX;
+        std::strncpy(sa.sun_path, a.path.c_str(), sizeof(sa.sun_path) - 1);
+        int rc;
+        if (listening) {
+            unlink(a.path.c_str());
+            rc = bind(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa));
+            if (rc == 0) rc = listen(fd, 8);
+        } else {
+            rc = connect(fd, reinterpret_cast<sockaddr*>(&sa), sizeof(sa));
+        }
+        if (rc != 0) { close(fd); return -1; }
+        return fd;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (listening) hints.ai_flags = AI_PASSIVE;
+    addrinfo* res = nullptr;
+    const char* host = a.host.empty() ? nullptr : a.host.c_str();
+    if (getaddrinfo(host, a.port.c_str(), &hints, &res) != 0) return -1;
+    int fd = -1;
+    for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        int one = 1;
+        int rc;
+        if (listening) {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            rc = bind(fd, ai->ai_addr, ai->ai_addrlen);
+            if (rc == 0) rc = listen(fd, 8);
+        } else {
+            rc = connect(fd, ai->ai_addr, ai->ai_addrlen);
+            if (rc == 0) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        if (rc == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+// One newline-delimited JSON connection.
+class Channel {
+public:
+    explicit Channel(int fd) : fd_(fd) {}
+    ~Channel() { if (fd_ >= 0) close(fd_); }
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    int fd() const { return fd_; }
+
+    bool send(const nlohmann::json& msg) {
+        std::string line = msg.dump() + "\n";
+        const char* p = line.data();
+        size_t left = line.size();
+        while (left > 0) {
+            ssize_t n = ::send(fd_, p, left, 0);
+            if (n <= 0) return false;
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Reads whatever is available; false on EOF or error.
+    bool fill() {
+        char buf[65536];
+        ssize_t n = ::recv(fd_, buf, sizeof(buf), 0);
+        if (n <= 0) return false;
+        buf_.append(buf, static_cast<size_t>(n));
+        return true;
+    }
+
+    // Pops one buffered message; malformed lines become an error message.
+    bool next(nlohmann::json& msg) {
+        auto nl = buf_.find('\n');
+        if (nl == std::string::npos) return false;
+        std::string line = buf_.substr(0, nl);
+        buf_.erase(0, nl + 1);
+        msg = nlohmann::json::parse(line, nullptr, false);
+        if (msg.is_discarded() || !msg.is_object()) msg = {{"type", "error"}, {"message", "malformed message"}};
+        return true;
+    }
+
+    // 1 = message, 0 = timeout, -1 = connection closed. timeout_ms < 0 waits forever.
+    int recv(nlohmann::json& msg, int timeout_ms) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (!next(msg)) {
+            int wait = -1;
+            if (timeout_ms >= 0) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+                if (left <= 0) return 0;
+                wait = static_cast<int>(left);
+            }
+            pollfd pfd{fd_, POLLIN, 0};
+            int rc = poll(&pfd, 1, wait);
+            if (rc == 0) return 0;
+            if (rc < 0 || !fill()) return -1;
+        }
+        return 1;
+    }
+
+private:
+    int fd_;
+    std::string buf_;
+};
+
+std::string local_hostname() {
+    char buf[256] = {};
+    if (gethostname(buf, sizeof(buf) - 1) != 0) return "unknown";
+    return buf;
+}
+
+nlohmann::json error_message(const std::string& what) {
+    return {{"type", "error"}, {"message", what}};
+}
+
+void serve_session(Channel& ch) {
+    nlohmann::json msg;
+    if (ch.recv(msg, 30000) <= 0 || msg.value("type", "") != "prepare") {
+        ch.send(error_message("expected prepare"));
+        return;
+    }
+    RunConfig cfg;
+    // The coordinator leaves "threads" out unless it was given explicitly.
+    cfg.threads = std::max(1u, std::thread::hardware_concurrency());
+    try {
+        apply_run_config(msg.at("config"), cfg);
+    } catch (std::exception& e) {
+        ch.send(error_message(std::string("bad config: ") + e.what()));
+        return;
+    }
+    auto workload = WorkloadRegistry::instance().create(cfg.workload);
+    if (!workload) {
+        ch.send(error_message("unknown workload '" + cfg.workload + "'"));
+        return;
+    }
+    try {
+        workload->configure(cfg.params);
+    } catch (std::exception& e) {
+        ch.send(error_message(std::string("invalid parameters: ") + e.what()));
+        return;
+    }
+    try {
+        workload->init(cfg.threads, cfg.workset_bytes);
+    } catch (std::exception& e) {
+        ch.send(error_message(std::string("init failed: ") + e.what()));
+        return;
+    }
+    std::string hostname = local_hostname();
+    if (!ch.send({{"type", "ready"}, {"hostname", hostname}, {"pid", static_cast<int>(getpid())}})) {
+        workload->shutdown();
+        return;
+    }
+
+    // Start barrier: the coordinator releases every agent once all are ready.
+    if (ch.recv(msg, -1) <= 0 || msg.value("type", "") != "start") {
+        workload->shutdown();
+        return;
+    }
+    std::cout << "Running '" << cfg.workload << "' for " << cfg.duration_seconds << "s with " << cfg.threads << " threads" << std::endl;
+    RunResult r;
+    try {
+        r = run_workload(*workload, cfg, false, [&](const IntervalSample& s) {
+            ch.send({{"type", "interval"}, {"index", s.index}, {"elapsed_seconds", s.elapsed_seconds},
+                     {"batches", s.batches}, {"throughput_batches_per_s", s.throughput_batches_per_s}});
+        });
+    } catch (std::exception& e) {
+        workload->shutdown();
+        ch.send(error_message(std::string("run failed: ") + e.what()));
+        return;
+    }
+    workload->shutdown();
+    nlohmann::json res = result_to_json(cfg, r);
+    res["hostname"] = hostname;
+    ch.send({{"type", "result"}, {"result", res}});
+    std::cout << "Done: " << r.total_batches << " batches" << std::endl;
+}
+
+} // namespace
+
+int run_agent(const std::string& listen_address) {
+    std::signal(SIGPIPE, SIG_IGN);
+    Address addr;
+    if (!parse_address(listen_address, addr)) {
+        std::cerr << "Invalid agent address '" << listen_address << "' (use host:port or unix:/path)" << std::endl;
+        return 1;
+    }
+    int lfd = open_socket(addr, true);
+    if (lfd < 0) {
+        std::cerr << "Failed to listen on " << listen_address << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    std::cout << "Agent listening on " << listen_address << std::endl;
+    for (;;) {
+        int fd = accept(lfd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "accept failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        Channel ch(fd);
+        serve_session(ch);
+    }
+    close(lfd);
+    if (addr.is_unix) unlink(addr.path.c_str());
+    return 1;
+}
+
+int run_coordinator(const CoordinatorConfig& cfg, nlohmann::json& report) {
+    std::signal(SIGPIPE, SIG_IGN);
+    if (cfg.agents.empty()) {
+        std::cerr << "No agents given" << std::endl;
+        return 1;
+    }
+
+    // Agents may still be starting up, so keep retrying until the timeout.
+    std::vector<std::unique_ptr<Channel>> chans;
+    for (auto& a : cfg.agents) {
+        Address addr;
+        if (!parse_address(a, addr)) {
+            std::cerr << "Invalid agent address '" << a << "' (use host:port or unix:/path)" << std::endl;
+            return 1;
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(cfg.connect_timeout_seconds);
+        int fd = -1;
+        while ((fd = open_socket(addr, false)) < 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+        if (fd < 0) {
+            std::cerr << "Failed to connect to agent " << a << std::endl;
+            return 1;
+        }
+        chans.push_back(std::make_unique<Channel>(fd));
+    }
+
+    nlohmann::json jcfg = run_config_to_json(cfg.run);
+    if (cfg.run.threads <= 0) jcfg.erase("threads");
+    nlohmann::json prepare = {{"type", "prepare"}, {"config", jcfg}};
+    for (size_t i = 0; i < chans.size(); ++i) {
+        if (!chans[i]->send(prepare)) {
+            std::cerr << "Failed to send config to agent " << cfg.agents[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<nlohmann::json> hosts(chans.size());
+    for (size_t i = 0; i < chans.size(); ++i) {
+        nlohmann::json msg;
+        int rc = chans[i]->recv(msg, 300000);
+        if (rc <= 0 || msg.value("type", "") != "ready") {
+            std::string why = rc == 0 ? "timed out" : rc < 0 ? "connection closed" : msg.value("message", "unexpected reply");
+            std::cerr << "Agent " << cfg.agents[i] << " failed to prepare: " << why << std::endl;
+            return 1;
+        }
+        hosts[i]["agent"] = cfg.agents[i];
+        hosts[i]["hostname"] = msg.value("hostname", "");
+    }
+
+    std::cout << "All " << chans.size() << " agents ready, starting '" << cfg.run.workload << "' for "
+              << cfg.run.duration_seconds << " seconds with "
+              << (cfg.run.threads > 0 ? std::to_string(cfg.run.threads) + " threads each" : std::string("one thread per core on each agent"))
+              << "..." << std::endl;
+    nlohmann::json start = {{"type", "start"}};
+    for (size_t i = 0; i < chans.size(); ++i) {
+        if (!chans[i]->send(start)) {
+            std::cerr << "Failed to start agent " << cfg.agents[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<bool> done(chans.size(), false);
+    std::map<int, std::vector<double>> live;
+    size_t remaining = chans.size();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(cfg.run.duration_seconds + 120);
+    while (remaining > 0) {
+        for (size_t i = 0; i < chans.size(); ++i) {
+            nlohmann::json msg;
+            while (!done[i] && chans[i]->next(msg)) {
+                std::string type = msg.value("type", "");
+                if (type == "interval") {
+                    auto& v = live[msg.value("index", 0)];
+                    v.push_back(msg.value("throughput_batches_per_s", 0.0));
+                    if (v.size() == chans.size()) {
+                        double sum = 0.0;
+                        for (double x : v) sum += x;
+                        std::cout << "interval " << msg.value("index", 0) << ": " << std::fixed << std::setprecision(1)
+                                  << sum << " batches/s across " << v.size() << " agents" << std::endl;
+                    }
+                } else if (type == "result") {
+                    hosts[i]["result"] = msg["result"];
+                    done[i] = true;
+                    --remaining;
+                } else if (type == "error") {
+                    std::cerr << "Agent " << cfg.agents[i] << " failed: " << msg.value("message", "") << std::endl;
+                    return 1;
+                }
+            }
+        }
+        if (remaining == 0) break;
+        if (std::chrono::steady_clock::now() > deadline) {
+            std::cerr << "Timed out waiting for agent results" << std::endl;
+            return 1;
+        }
+
+        std::vector<pollfd> pfds;
+        std::vector<size_t> owners;
+        for (size_t i = 0; i < chans.size(); ++i) {
+            if (done[i]) continue;
+            pfds.push_back(pollfd{chans[i]->fd(), POLLIN, 0});
+            owners.push_back(i);
+        }
+        if (poll(pfds.data(), pfds.size(), 250) < 0 && errno != EINTR) {
+            std::cerr << "poll failed: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        for (size_t k = 0; k < pfds.size(); ++k) {
+            if (!(pfds[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            if (!chans[owners[k]]->fill()) {
+                std::cerr << "Agent " << cfg.agents[owners[k]] << " closed the connection before reporting" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    report = aggregate_host_results(hosts, cfg.run, cfg.outlier_threshold);
+    return 0;
+}
+
+#else
+
+int run_agent(const std::string&) {
+    std::cerr << "Agent mode is not supported on this platform" << std::endl;
+    return 1;
+}
+
+int run_coordinator(const CoordinatorConfig&, nlohmann::json&) {
+    std::cerr << "Coordinator mode is not supported on this platform" << std::endl;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include "histogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr uint64_t kSubCount = uint64_t(1) << LatencyHistogram::kSubBits;
+constexpr size_t kBucketCount = (64 - LatencyHistogram::kSubBits + 1) * kSubCount;
+
+int floor_log2(uint64_t v) {
+    int e = 0;
+    while (v >>= 1) ++e;
+    return e;
+}
+}
+
+LatencyHistogram::LatencyHistogram() : counts_(kBucketCount, 0) {}
+
+size_t LatencyHistogram::bucket_index(uint64_t value) {
+    if (value < kSubCount) return static_cast<size_t>(value);
+    int shift = floor_log2(value) - kSubBits;
+    return static_cast<size_t>((shift + 1) * kSubCount + ((value >> shift) & (kSubCount - 1)));
+}
+
+uint64_t LatencyHistogram::bucket_lower(size_t index) {
+    if (index < kSubCount) return index;
+    size_t shift = index / kSubCount - 1;
+    return (kSubCount + index % kSubCount) << shift;
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t index) {
+    if (index < kSubCount) return index;
+    size_t shift = index / kSubCount - 1;
+    return bucket_lower(index) + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    counts_[bucket_index(value)]++;
+    ++count_;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::add_bucket(size_t index, uint64_t count) {
+    if (index >= counts_.size() || count == 0) return;
+    counts_[index] += count;
+    count_ += count;
+    uint64_t lo = bucket_lower(index), hi = bucket_upper(index);
+    sum_ += static_cast<long double>(lo + (hi - lo) / 2) * count;
+    min_ = std::min(min_, lo);
+    max_ = std::max(max_, hi);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts_.size(); ++i) counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    if (other.count_) {
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+}
+
+void LatencyHistogram::set_bounds(uint64_t min, uint64_t max) {
+    if (count_ == 0 || min > max) return;
+    min_ = min;
+    max_ = max;
+}
+
+double LatencyHistogram::percentile(double p) const {
+    if (count_ == 0) return 0.0;
+    if (p <= 0) return static_cast<double>(min());
+    if (p >= 100) return static_cast<double>(max_);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100.0 * count_));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            uint64_t lo = bucket_lower(i), hi = bucket_upper(i);
+            double mid = lo + (hi - lo) / 2.0;
+            return std::min(std::max(mid, static_cast<double>(min())), static_cast<double>(max_));
+        }
+    }
+    return static_cast<double>(max_);
+}
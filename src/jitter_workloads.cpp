@@ -0,0 +1,199 @@
+#include "workload.hpp"
+#include "workload_registry.hpp"
+#include "workloads.hpp"
+#include "histogram.hpp"
+#include "runner.hpp"
+#include "utils.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+// OS jitter detector. Each benchmark thread pins itself to one CPU and spins
+// reading the clock; any gap between consecutive reads above the threshold is
+// time the core spent elsewhere (IRQs, timer ticks, SMIs, preemption,
+// migrations). Run with --threads equal to the number of CPUs to cover.
+//
+// Parameters (--param key=value):
+//   threshold_ns=1000  smallest gap counted as an interruption
+//   spin_ms=100        spin time per batch
+//   cpus=0,2-5         CPUs to pin to, one per thread in order; more threads
+//                      than CPUs is rejected (default: the process affinity mask)
+//   top=10             worst gaps kept per CPU
+
+namespace {
+
+std::vector<int> parse_cpu_list(const std::string& spec) {
+    std::vector<int> cpus;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        try {
+            auto dash = item.find('-');
+            int lo = std::stoi(item.substr(0, dash));
+            int hi = dash == std::string::npos ? lo : std::stoi(item.substr(dash + 1));
+            if (lo < 0 || hi < lo) throw std::invalid_argument(item);
+            for (int c = lo; c <= hi; ++c) cpus.push_back(c);
+        } catch (std::exception&) {
+            throw std::invalid_argument("bad cpu list entry '" + item + "' (expected e.g. 0,2-5)");
+        }
+    }
+    return cpus;
+}
+
+inline uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class JitterWorkload : public Workload {
+public:
+    void configure(const WorkloadParams& p) override {
+        threshold_ns_ = param_u64(p, "threshold_ns", 1000);
+        spin_ns_ = param_u64(p, "spin_ms", 100) * 1000000ull;
+        top_ = param_u64(p, "top", 10);
+        cpus_ = parse_cpu_list(param_string(p, "cpus", ""));
+        if (threshold_ns_ == 0 || spin_ns_ == 0) throw std::invalid_argument("threshold_ns and spin_ms must be > 0");
+    }
+
+    void init(int threads, size_t /*workset_bytes*/) override {
+        slots_.reset(threads);
+        std::vector<int> cpus = cpus_.empty() ? allowed_cpus() : cpus_;
+        // Two spinners on one core would time-slice each other and report it
+        // as OS jitter, so every thread needs a CPU of its own.
+        if (!cpus.empty() && static_cast<size_t>(threads) > cpus.size())
+            throw std::invalid_argument("jitter needs one CPU per thread: " + std::to_string(threads) + " threads but only " +
+                                        std::to_string(cpus.size()) + " CPUs available; lower --threads or widen cpus=");
+        cores_.clear();
+        for (int i = 0; i < slots_.size(); ++i) {
+            auto c = std::make_unique<Core>();
+            c->cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+            cores_.push_back(std::move(c));
+        }
+        // Gap timestamps count from the first batch, not from here: agents and
+        // suites initialise well before the run actually starts.
+        started_ = std::make_unique<std::once_flag>();
+    }
+
+    uint64_t run_batch() override {
+        std::call_once(*started_, [this]() {
+            t0_ns_ = now_ns();
+            t0_unix_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        });
+        Core& c = *cores_[slots_.current()];
+        if (!c.pin_attempted) {
+            c.pinned = pin_current_thread(c.cpu);
+            c.pin_attempted = true;
+        }
+
+        uint64_t start = now_ns();
+        uint64_t end = start + spin_ns_;
+        uint64_t prev = start;
+        uint64_t gaps = 0;
+        while (prev < end) {
+            uint64_t now = now_ns();
+            uint64_t gap = now - prev;
+            if (gap > threshold_ns_) {
+                c.hist.record(gap);
+                c.stolen_ns += gap;
+                ++gaps;
+                remember(c, gap, prev - t0_ns_);
+            }
+            prev = now;
+        }
+        c.spin_ns += prev - start;
+        if (c.pinned && current_cpu() != c.cpu) ++c.migrations;
+        return gaps;
+    }
+
+    void shutdown() override { cores_.clear(); }
+    std::string name() const override { return "jitter"; }
+
+    void report(nlohmann::json& out, double /*elapsed_seconds*/) const override {
+        uint64_t stolen = 0, spun = 0, gaps = 0;
+        std::vector<std::pair<int, Gap>> worst;
+        nlohmann::json jcpus = nlohmann::json::array();
+        for (auto& c : cores_) {
+            stolen += c->stolen_ns;
+            spun += c->spin_ns;
+            gaps += c->hist.count();
+            nlohmann::json jc;
+            jc["cpu"] = c->cpu;
+            jc["pinned"] = c->pinned;
+            jc["spin_seconds"] = c->spin_ns / 1e9;
+            jc["interruptions"] = c->hist.count();
+            jc["stolen_ns"] = c->stolen_ns;
+            jc["stolen_fraction"] = c->spin_ns ? static_cast<double>(c->stolen_ns) / c->spin_ns : 0.0;
+            jc["interruptions_per_s"] = c->spin_ns ? c->hist.count() / (c->spin_ns / 1e9) : 0.0;
+            jc["gap_p50_ns"] = c->hist.percentile(50);
+            jc["gap_p99_ns"] = c->hist.percentile(99);
+            jc["max_gap_ns"] = c->hist.max();
+            jc["migrations"] = c->migrations;
+            jc["histogram"] = histogram_to_json(c->hist);
+            jcpus.push_back(jc);
+            for (auto& g : c->worst) worst.emplace_back(c->cpu, g);
+        }
+        std::sort(worst.begin(), worst.end(), [](const std::pair<int, Gap>& a, const std::pair<int, Gap>& b) {
+            return a.second.gap_ns > b.second.gap_ns;
+        });
+        if (worst.size() > top_) worst.resize(top_);
+        nlohmann::json jworst = nlohmann::json::array();
+        for (auto& w : worst) {
+            jworst.push_back({{"cpu", w.first}, {"gap_ns", w.second.gap_ns},
+                              {"at_seconds", w.second.at_ns / 1e9}, {"unix_ns", t0_unix_ns_ + w.second.at_ns}});
+        }
+        out["threshold_ns"] = threshold_ns_;
+        out["interruptions"] = gaps;
+        out["total_stolen_ns"] = stolen;
+        out["stolen_fraction"] = spun ? static_cast<double>(stolen) / spun : 0.0;
+        out["worst_gaps"] = jworst;
+        out["cpus"] = jcpus;
+    }
+
+private:
+    struct Gap { uint64_t gap_ns; uint64_t at_ns; };
+    struct Core {
+        int cpu = -1;
+        bool pin_attempted = false;
+        bool pinned = false;
+        uint64_t spin_ns = 0, stolen_ns = 0, migrations = 0;
+        LatencyHistogram hist;
+        std::vector<Gap> worst; // min-heap on gap_ns, at most top_ entries
+    };
+
+    void remember(Core& c, uint64_t gap, uint64_t at) {
+        auto cmp = [](const Gap& a, const Gap& b) { return a.gap_ns > b.gap_ns; };
+        if (c.worst.size() < top_) {
+            c.worst.push_back(Gap{gap, at});
+            std::push_heap(c.worst.begin(), c.worst.end(), cmp);
+        } else if (top_ > 0 && gap > c.worst.front().gap_ns) {
+            std::pop_heap(c.worst.begin(), c.worst.end(), cmp);
+            c.worst.back() = Gap{gap, at};
+            std::push_heap(c.worst.begin(), c.worst.end(), cmp);
+        }
+    }
+
+    ThreadSlots slots_;
+    std::vector<std::unique_ptr<Core>> cores_;
+    std::vector<int> cpus_;
+    uint64_t threshold_ns_ = 1000;
+    uint64_t spin_ns_ = 100000000;
+    uint64_t top_ = 10;
+    std::unique_ptr<std::once_flag> started_;
+    uint64_t t0_ns_ = 0;
+    uint64_t t0_unix_ns_ = 0;
+};
+
+} // namespace
+
+void register_jitter_workloads() {
+    WorkloadRegistry::instance().register_factory("jitter", []() -> std::unique_ptr<Workload> {
+        return std::make_unique<JitterWorkload>();
+    });
+}
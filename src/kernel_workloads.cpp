@@ -0,0 +1,578 @@
+#include "workload.hpp"
+#include "workload_registry.hpp"
+#include "workloads.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define PULSEBENCH_CRC32C_HW 1
+#endif
+
+// Application-like kernels. Each thread works on its own partition of the
+// workset and the results are reported in domain units (probes/s, keys/s,
+// tuples/s, GB/s) under "metrics", with "throughput"/"throughput_unit" as the
+// headline figure.
+//
+//   hashtable  open-addressing insert/probe     load_factor=0.5 mode=probe|insert hit_ratio=0.5 batch_ops=65536
+//   sort       per-thread partition sort        algo=radix|merge
+//   hashjoin   radix-partitioned hash join      partitions=64 probe_ratio=4
+//   checksum   checksum over buffers            algo=crc32c|xxhash64 buffer_bytes=65536 impl=auto|sw|hw
+
+namespace {
+
+// splitmix64 finalizer: a bijection, so distinct indices give distinct keys.
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27; x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+inline uint64_t next_rand(uint64_t& s) {
+    s += 0x9E3779B97F4A7C15ull;
+    return mix64(s);
+}
+
+inline size_t floor_pow2(size_t n) {
+    size_t p = 1;
+    while (p * 2 <= n) p *= 2;
+    return p;
+}
+
+size_t per_thread_bytes(size_t workset_bytes, int threads) {
+    return workset_bytes / static_cast<size_t>(threads > 0 ? threads : 1);
+}
+
+void set_throughput(nlohmann::json& out, double value, const char* unit) {
+    out["throughput"] = value;
+    out["throughput_unit"] = unit;
+}
+
+// ---------------------------------------------------------------------------
+// Open-addressing hash table (linear probing, 16-byte slots, key 0 = empty).
+
+class HashTableWorkload : public Workload {
+public:
+    void configure(const WorkloadParams& p) override {
+        load_factor_ = param_double(p, "load_factor", 0.5);
+        hit_ratio_ = param_double(p, "hit_ratio", 0.5);
+        batch_ops_ = param_u64(p, "batch_ops", 65536);
+        mode_ = param_string(p, "mode", "probe");
+        if (load_factor_ <= 0 || load_factor_ > 0.95) throw std::invalid_argument("load_factor must be in (0, 0.95]");
+        if (hit_ratio_ < 0 || hit_ratio_ > 1) throw std::invalid_argument("hit_ratio must be in [0, 1]");
+        if (mode_ != "probe" && mode_ != "insert") throw std::invalid_argument("mode must be probe or insert");
+        if (batch_ops_ == 0) throw std::invalid_argument("batch_ops must be > 0");
+    }
+
+    void init(int threads, size_t workset_bytes) override {
+        slots_.reset(threads);
+        parts_.clear();
+        shape_ = {threads, workset_bytes};
+        size_t capacity = floor_pow2(std::max<size_t>(per_thread_bytes(workset_bytes, threads) / sizeof(Slot), 1024));
+        for (int i = 0; i < slots_.size(); ++i) {
+            auto t = std::make_unique<Part>();
+            t->table.assign(capacity, Slot{});
+            t->mask = capacity - 1;
+            // Tiny load factors on small tables would round down to no keys at all.
+            t->keys = std::max<uint64_t>(static_cast<uint64_t>(load_factor_ * capacity), 1);
+            t->seed = 0xA5A5A5A5ull * (i + 1);
+            if (mode_ == "insert") {
+                t->track_filled = true;
+                t->filled.reserve(t->keys);
+            }
+            fill(*t);
+            parts_.push_back(std::move(t));
+        }
+    }
+
+    uint64_t run_batch() override {
+        Part& t = *parts_[slots_.current()];
+        if (mode_ == "insert") {
+            // Empty only the slots the last fill used: clearing the whole table
+            // would cost capacity * 16 bytes per batch whatever the load factor.
+            for (size_t pos : t.filled) t.table[pos] = Slot{};
+            t.filled.clear();
+            t.probe_steps += fill(t);
+            t.ops += t.keys;
+            return t.keys;
+        }
+        uint64_t found = 0;
+        for (uint64_t i = 0; i < batch_ops_; ++i) {
+            uint64_t r = next_rand(t.seed);
+            bool hit = (r >> 11) * (1.0 / 9007199254740992.0) < hit_ratio_;
+            uint64_t idx = hit ? (r % t.keys) : t.keys + (r % t.keys);
+            uint64_t key = mix64(idx + 1);
+            size_t pos = mix64(key) & t.mask;
+            uint64_t steps = 1;
+            while (t.table[pos].key != 0) {
+                if (t.table[pos].key == key) { found += t.table[pos].value; break; }
+                pos = (pos + 1) & t.mask;
+                ++steps;
+            }
+            t.probe_steps += steps;
+        }
+        t.ops += batch_ops_;
+        t.sink += found;
+        return batch_ops_;
+    }
+
+    void shutdown() override { parts_.clear(); }
+    std::string name() const override { return "hashtable"; }
+
+    bool reuse(int threads, size_t workset_bytes) override {
+        if (shape_ != std::make_pair(threads, workset_bytes)) return false;
+        slots_.reset(threads);
+        for (auto& t : parts_) t->ops = t->probe_steps = 0;
+        return true;
+    }
+
+    void report(nlohmann::json& out, double elapsed_seconds) const override {
+        uint64_t ops = 0, steps = 0, capacity = 0, keys = 0;
+        for (auto& t : parts_) { ops += t->ops; steps += t->probe_steps; capacity += t->table.size(); keys += t->keys; }
+        double rate = elapsed_seconds > 0 ? ops / elapsed_seconds : 0.0;
+        out["mode"] = mode_;
+        out["load_factor"] = load_factor_;
+        out["table_slots"] = capacity;
+        out["table_keys"] = keys;
+        out[mode_ == "insert" ? "inserts_per_s" : "probes_per_s"] = rate;
+        out["avg_probe_length"] = ops ? static_cast<double>(steps) / ops : 0.0;
+        set_throughput(out, rate, mode_ == "insert" ? "inserts/s" : "probes/s");
+    }
+
+private:
+    struct Slot { uint64_t key = 0; uint64_t value = 0; };
+    struct Part {
+        std::vector<Slot> table;
+        size_t mask = 0;
+        uint64_t keys = 0;
+        bool track_filled = false; // insert mode: remember occupied slots in `filled`
+        std::vector<size_t> filled;
+        uint64_t seed = 0;
+        uint64_t ops = 0, probe_steps = 0, sink = 0;
+    };
+
+    // Inserts keys mix64(1..keys); returns the number of slots touched.
+    static uint64_t fill(Part& t) {
+        uint64_t steps = 0;
+        for (uint64_t i = 0; i < t.keys; ++i) {
+            uint64_t key = mix64(i + 1);
+            size_t pos = mix64(key) & t.mask;
+            ++steps;
+            while (t.table[pos].key != 0) { pos = (pos + 1) & t.mask; ++steps; }
+            t.table[pos].key = key;
+            t.table[pos].value = i;
+            if (t.track_filled) t.filled.push_back(pos);
+        }
+        return steps;
+    }
+
+    ThreadSlots slots_;
+    std::vector<std::unique_ptr<Part>> parts_;
+    std::pair<int, size_t> shape_;
+    double load_factor_ = 0.5;
+    double hit_ratio_ = 0.5;
+    uint64_t batch_ops_ = 65536;
+    std::string mode_ = "probe";
+};
+
+// ---------------------------------------------------------------------------
+// Per-thread partition sort: each batch restores the unsorted partition and
+// sorts it, so the copy is part of the measured cost (as in a real sort stage).
+
+void radix_sort(std::vector<uint64_t>& keys, std::vector<uint64_t>& tmp) {
+    tmp.resize(keys.size());
+    uint64_t* src = keys.data();
+    uint64_t* dst = tmp.data();
+    size_t n = keys.size();
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t count[256] = {};
+        for (size_t i = 0; i < n; ++i) count[(src[i] >> shift) & 0xFF]++;
+        // All keys share this digit: the pass would be an identity permutation.
+        if (count[(src[0] >> shift) & 0xFF] == n) continue;
+        size_t sum = 0;
+        for (size_t& c : count) { size_t v = c; c = sum; sum += v; }
+        for (size_t i = 0; i < n; ++i) dst[count[(src[i] >> shift) & 0xFF]++] = src[i];
+        std::swap(src, dst);
+    }
+    if (src != keys.data()) std::memcpy(keys.data(), src, n * sizeof(uint64_t));
+}
+
+class SortWorkload : public Workload {
+public:
+    void configure(const WorkloadParams& p) override {
+        algo_ = param_string(p, "algo", "radix");
+        if (algo_ != "radix" && algo_ != "merge") throw std::invalid_argument("algo must be radix or merge");
+    }
+
+    void init(int threads, size_t workset_bytes) override {
+        slots_.reset(threads);
+        parts_.clear();
+        shape_ = {threads, workset_bytes};
+        // pristine + working + scratch copy per thread
+        size_t n = std::max<size_t>(per_thread_bytes(workset_bytes, threads) / (3 * sizeof(uint64_t)), 1024);
+        for (int i = 0; i < slots_.size(); ++i) {
+            auto t = std::make_unique<Part>();
+            uint64_t seed = 0x5EED0000ull + i;
+            t->source.resize(n);
+            for (auto& k : t->source) k = next_rand(seed);
+            t->work.resize(n);
+            parts_.push_back(std::move(t));
+        }
+    }
+
+    uint64_t run_batch() override {
+        Part& t = *parts_[slots_.current()];
+        std::memcpy(t.work.data(), t.source.data(), t.source.size() * sizeof(uint64_t));
+        if (algo_ == "radix") radix_sort(t.work, t.tmp);
+        else std::stable_sort(t.work.begin(), t.work.end());
+        t.keys += t.work.size();
+        return t.work.size();
+    }
+
+    void shutdown() override { parts_.clear(); }
+    std::string name() const override { return "sort"; }
+
+    bool reuse(int threads, size_t workset_bytes) override {
+        if (shape_ != std::make_pair(threads, workset_bytes)) return false;
+        slots_.reset(threads);
+        for (auto& t : parts_) t->keys = 0;
+        return true;
+    }
+
+    void report(nlohmann::json& out, double elapsed_seconds) const override {
+        uint64_t keys = 0, partition = 0;
+        for (auto& t : parts_) { keys += t->keys; partition = t->source.size(); }
+        double rate = elapsed_seconds > 0 ? keys / elapsed_seconds : 0.0;
+        out["algo"] = algo_;
+        out["keys_per_partition"] = partition;
+        out["keys_per_s"] = rate;
+        set_throughput(out, rate, "keys/s");
+    }
+
+private:
+    struct Part {
+        std::vector<uint64_t> source, work, tmp;
+        uint64_t keys = 0;
+    };
+
+    ThreadSlots slots_;
+    std::vector<std::unique_ptr<Part>> parts_;
+    std::pair<int, size_t> shape_;
+    std::string algo_ = "radix";
+};
+
+// ---------------------------------------------------------------------------
+// Radix-partitioned hash join of R (unique keys) with S (foreign keys into R).
+// Each batch partitions both sides by key hash, then builds and probes one
+// cache-sized table per partition.
+
+class HashJoinWorkload : public Workload {
+public:
+    void configure(const WorkloadParams& p) override {
+        partitions_ = param_u64(p, "partitions", 64);
+        probe_ratio_ = param_u64(p, "probe_ratio", 4);
+        if (partitions_ == 0 || (partitions_ & (partitions_ - 1)) != 0)
+            throw std::invalid_argument("partitions must be a power of two");
+        if (probe_ratio_ == 0) throw std::invalid_argument("probe_ratio must be > 0");
+    }
+
+    void init(int threads, size_t workset_bytes) override {
+        slots_.reset(threads);
+        parts_.clear();
+        shape_ = {threads, workset_bytes};
+        // Every tuple is stored twice (input + partitioned copy).
+        size_t tuples = std::max<size_t>(per_thread_bytes(workset_bytes, threads) / (2 * sizeof(Tuple)), 1024);
+        size_t nr = std::max<size_t>(tuples / (1 + probe_ratio_), 64);
+        size_t ns = nr * probe_ratio_;
+        for (int i = 0; i < slots_.size(); ++i) {
+            auto t = std::make_unique<Part>();
+            uint64_t seed = 0x10140000ull + i;
+            t->r.resize(nr);
+            for (size_t k = 0; k < nr; ++k) t->r[k] = Tuple{mix64(k + 1 + (uint64_t(i) << 40)), k};
+            t->s.resize(ns);
+            for (size_t k = 0; k < ns; ++k) t->s[k] = Tuple{t->r[next_rand(seed) % nr].key, k};
+            t->r_part.resize(nr);
+            t->s_part.resize(ns);
+            parts_.push_back(std::move(t));
+        }
+    }
+
+    uint64_t run_batch() override {
+        Part& t = *parts_[slots_.current()];
+        std::vector<size_t> r_off, s_off;
+        partition(t.r, t.r_part, r_off);
+        partition(t.s, t.s_part, s_off);
+
+        uint64_t matches = 0;
+        for (size_t p = 0; p < partitions_; ++p) {
+            size_t rb = r_off[p], re = r_off[p + 1];
+            size_t cap = floor_pow2(std::max<size_t>((re - rb) * 2, 16)) * 2;
+            if (t.table.size() < cap) t.table.resize(cap);
+            std::fill(t.table.begin(), t.table.begin() + cap, Tuple{});
+            size_t mask = cap - 1;
+            for (size_t i = rb; i < re; ++i) {
+                // Low bits picked the partition; use the high bits inside it.
+                size_t pos = (mix64(t.r_part[i].key) >> 32) & mask;
+                while (t.table[pos].key != 0) pos = (pos + 1) & mask;
+                t.table[pos] = t.r_part[i];
+            }
+            for (size_t i = s_off[p]; i < s_off[p + 1]; ++i) {
+                uint64_t key = t.s_part[i].key;
+                size_t pos = (mix64(key) >> 32) & mask;
+                while (t.table[pos].key != 0) {
+                    if (t.table[pos].key == key) { ++matches; t.sink += t.table[pos].payload; break; }
+                    pos = (pos + 1) & mask;
+                }
+            }
+        }
+        t.tuples += t.r.size() + t.s.size();
+        t.matches += matches;
+        return matches;
+    }
+
+    void shutdown() override { parts_.clear(); }
+    std::string name() const override { return "hashjoin"; }
+
+    bool reuse(int threads, size_t workset_bytes) override {
+        if (shape_ != std::make_pair(threads, workset_bytes)) return false;
+        slots_.reset(threads);
+        for (auto& t : parts_) t->tuples = t->matches = 0;
+        return true;
+    }
+
+    void report(nlohmann::json& out, double elapsed_seconds) const override {
+        uint64_t tuples = 0, matches = 0;
+        for (auto& t : parts_) { tuples += t->tuples; matches += t->matches; }
+        double rate = elapsed_seconds > 0 ? tuples / elapsed_seconds : 0.0;
+        out["partitions"] = partitions_;
+        out["build_rows_per_thread"] = parts_.empty() ? 0 : parts_[0]->r.size();
+        out["probe_rows_per_thread"] = parts_.empty() ? 0 : parts_[0]->s.size();
+        out["matches"] = matches;
+        out["tuples_per_s"] = rate;
+        set_throughput(out, rate, "tuples/s");
+    }
+
+private:
+    struct Tuple { uint64_t key = 0; uint64_t payload = 0; };
+    struct Part {
+        std::vector<Tuple> r, s, r_part, s_part, table;
+        uint64_t tuples = 0, matches = 0, sink = 0;
+    };
+
+    void partition(const std::vector<Tuple>& in, std::vector<Tuple>& out, std::vector<size_t>& offsets) const {
+        size_t mask = partitions_ - 1;
+        offsets.assign(partitions_ + 1, 0);
+        for (auto& tup : in) offsets[(mix64(tup.key) & mask) + 1]++;
+        for (size_t p = 0; p < partitions_; ++p) offsets[p + 1] += offsets[p];
+        std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (auto& tup : in) out[cursor[mix64(tup.key) & mask]++] = tup;
+    }
+
+    ThreadSlots slots_;
+    std::vector<std::unique_ptr<Part>> parts_;
+    std::pair<int, size_t> shape_;
+    uint64_t partitions_ = 64;
+    uint64_t probe_ratio_ = 4;
+};
+
+// ---------------------------------------------------------------------------
+// Checksums: CRC32C (slicing-by-8, or SSE4.2 crc32 when the CPU has it) and
+// XXH64.
+
+struct Crc32cTables {
+    uint32_t t[8][256];
+    Crc32cTables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1)));
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i)
+            for (int s = 1; s < 8; ++s) t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+    }
+};
+
+uint32_t crc32c_sw(uint32_t crc, const unsigned char* p, size_t n) {
+    static const Crc32cTables tables;
+    const auto& t = tables.t;
+    crc = ~crc;
+    while (n >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        v ^= crc;
+        crc = t[7][v & 0xFF] ^ t[6][(v >> 8) & 0xFF] ^ t[5][(v >> 16) & 0xFF] ^ t[4][(v >> 24) & 0xFF] ^
+              t[3][(v >> 32) & 0xFF] ^ t[2][(v >> 40) & 0xFF] ^ t[1][(v >> 48) & 0xFF] ^ t[0][v >> 56];
+        p += 8;
+        n -= 8;
+    }
+    while (n--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    return ~crc;
+}
+
+#ifdef PULSEBENCH_CRC32C_HW
+__attribute__((target("sse4.2")))
+uint32_t crc32c_hw(uint32_t crc, const unsigned char* p, size_t n) {
+    crc = ~crc;
+#ifdef __x86_64__
+    uint64_t c = crc;
+    while (n >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        n -= 8;
+    }
+    crc = static_cast<uint32_t>(c);
+#endif
+    while (n--) crc = _mm_crc32_u8(crc, *p++);
+    return ~crc;
+}
+
+bool crc32c_hw_available() { return __builtin_cpu_supports("sse4.2"); }
+#else
+uint32_t crc32c_hw(uint32_t crc, const unsigned char* p, size_t n) { return crc32c_sw(crc, p, n); }
+bool crc32c_hw_available() { return false; }
+#endif
+
+constexpr uint64_t kXxP1 = 11400714785074694791ull;
+constexpr uint64_t kXxP2 = 14029467366897019727ull;
+constexpr uint64_t kXxP3 = 1609587929392839161ull;
+constexpr uint64_t kXxP4 = 9650029242287828579ull;
+constexpr uint64_t kXxP5 = 2870177450012600261ull;
+
+inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+inline uint64_t read64(const unsigned char* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+inline uint32_t read32(const unsigned char* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+inline uint64_t xx_round(uint64_t acc, uint64_t input) { return rotl64(acc + input * kXxP2, 31) * kXxP1; }
+inline uint64_t xx_merge(uint64_t acc, uint64_t val) { return (acc ^ xx_round(0, val)) * kXxP1 + kXxP4; }
+
+// Little-endian hosts only, which covers every platform PulseBench builds on.
+uint64_t xxhash64(const unsigned char* p, size_t len, uint64_t seed) {
+    const unsigned char* end = p + len;
+    uint64_t h;
+    if (len >= 32) {
+        uint64_t v1 = seed + kXxP1 + kXxP2, v2 = seed + kXxP2, v3 = seed, v4 = seed - kXxP1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = xx_round(v1, read64(p)); v2 = xx_round(v2, read64(p + 8));
+            v3 = xx_round(v3, read64(p + 16)); v4 = xx_round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xx_merge(h, v1); h = xx_merge(h, v2); h = xx_merge(h, v3); h = xx_merge(h, v4);
+    } else {
+        h = seed + kXxP5;
+    }
+    h += len;
+    for (; p + 8 <= end; p += 8) h = rotl64(h ^ xx_round(0, read64(p)), 27) * kXxP1 + kXxP4;
+    if (p + 4 <= end) { h = rotl64(h ^ (read32(p) * kXxP1), 23) * kXxP2 + kXxP3; p += 4; }
+    for (; p < end; ++p) h = rotl64(h ^ (*p * kXxP5), 11) * kXxP1;
+    h ^= h >> 33; h *= kXxP2;
+    h ^= h >> 29; h *= kXxP3;
+    h ^= h >> 32;
+    return h;
+}
+
+class ChecksumWorkload : public Workload {
+public:
+    void configure(const WorkloadParams& p) override {
+        algo_ = param_string(p, "algo", "crc32c");
+        impl_ = param_string(p, "impl", "auto");
+        buffer_bytes_ = param_u64(p, "buffer_bytes", 65536);
+        if (algo_ != "crc32c" && algo_ != "xxhash64") throw std::invalid_argument("algo must be crc32c or xxhash64");
+        if (impl_ != "auto" && impl_ != "sw" && impl_ != "hw") throw std::invalid_argument("impl must be auto, sw or hw");
+        if (impl_ == "hw" && !crc32c_hw_available()) throw std::invalid_argument("impl=hw: CPU has no CRC32C instruction");
+        if (buffer_bytes_ == 0) throw std::invalid_argument("buffer_bytes must be > 0");
+        use_hw_ = algo_ == "crc32c" && impl_ != "sw" && crc32c_hw_available();
+    }
+
+    void init(int threads, size_t workset_bytes) override {
+        slots_.reset(threads);
+        parts_.clear();
+        shape_ = {threads, workset_bytes};
+        size_t n = std::max<size_t>(per_thread_bytes(workset_bytes, threads), buffer_bytes_);
+        for (int i = 0; i < slots_.size(); ++i) {
+            auto t = std::make_unique<Part>();
+            uint64_t seed = 0xC4C4ull + i;
+            t->data.resize(n);
+            for (auto& b : t->data) b = static_cast<unsigned char>(next_rand(seed));
+            parts_.push_back(std::move(t));
+        }
+    }
+
+    uint64_t run_batch() override {
+        Part& t = *parts_[slots_.current()];
+        const unsigned char* base = t.data.data();
+        size_t n = t.data.size();
+        uint64_t acc = 0;
+        for (size_t off = 0; off < n; off += buffer_bytes_) {
+            size_t len = std::min<size_t>(buffer_bytes_, n - off);
+            if (algo_ == "xxhash64") acc ^= xxhash64(base + off, len, 0);
+            else if (use_hw_) acc ^= crc32c_hw(0, base + off, len);
+            else acc ^= crc32c_sw(0, base + off, len);
+        }
+        t.bytes += n;
+        t.sink ^= acc;
+        return n;
+    }
+
+    void shutdown() override { parts_.clear(); }
+    std::string name() const override { return "checksum"; }
+
+    bool reuse(int threads, size_t workset_bytes) override {
+        if (shape_ != std::make_pair(threads, workset_bytes)) return false;
+        slots_.reset(threads);
+        for (auto& t : parts_) t->bytes = 0;
+        return true;
+    }
+
+    void report(nlohmann::json& out, double elapsed_seconds) const override {
+        uint64_t bytes = 0;
+        for (auto& t : parts_) bytes += t->bytes;
+        double gbps = elapsed_seconds > 0 ? bytes / elapsed_seconds / 1e9 : 0.0;
+        out["algo"] = algo_;
+        out["impl"] = algo_ == "crc32c" ? (use_hw_ ? "hw" : "sw") : "sw";
+        out["buffer_bytes"] = buffer_bytes_;
+        out["bytes"] = bytes;
+        out["gb_per_s"] = gbps;
+        set_throughput(out, gbps, "GB/s");
+    }
+
+private:
+    struct Part {
+        std::vector<unsigned char> data;
+        uint64_t bytes = 0, sink = 0;
+    };
+
+    ThreadSlots slots_;
+    std::vector<std::unique_ptr<Part>> parts_;
+    std::pair<int, size_t> shape_;
+    std::string algo_ = "crc32c";
+    std::string impl_ = "auto";
+    uint64_t buffer_bytes_ = 65536;
+    bool use_hw_ = false;
+};
+
+} // namespace
+
+void register_kernel_workloads() {
+    auto &reg = WorkloadRegistry::instance();
+    reg.register_factory("hashtable", []() -> std::unique_ptr<Workload> {
+        return std::make_unique<HashTableWorkload>();
+    });
+    reg.register_factory("sort", []() -> std::unique_ptr<Workload> {
+        return std::make_unique<SortWorkload>();
+    });
+    reg.register_factory("hashjoin", []() -> std::unique_ptr<Workload> {
+        return std::make_unique<HashJoinWorkload>();
+    });
+    reg.register_factory("checksum", []() -> std::unique_ptr<Workload> {
+        return std::make_unique<ChecksumWorkload>();
+    });
+}
@@ -50,6 +50,17 @@ PerfHandle* perf_create() {
     return h;
 }
 
+unsigned perf_opened(PerfHandle* h) {
+    if (!h) return 0;
+    unsigned bits = 0;
+    if (h->fd_instructions != -1) bits |= PERF_HAS_INSTRUCTIONS;
+    if (h->fd_cycles != -1) bits |= PERF_HAS_CYCLES;
+    if (h->fd_cache_refs != -1) bits |= PERF_HAS_CACHE_REFERENCES;
+    if (h->fd_cache_misses != -1) bits |= PERF_HAS_CACHE_MISSES;
+    if (h->fd_branch_misses != -1) bits |= PERF_HAS_BRANCH_MISSES;
+    return bits;
+}
+
 void perf_reset(PerfHandle* h) {
     if (!h) return;
     auto r = [&](int fd){ if (fd!=-1) ioctl(fd, PERF_EVENT_IOC_RESET, 0); };
@@ -96,6 +107,7 @@ void perf_destroy(PerfHandle* h) {
 
 struct PerfHandle {};
 PerfHandle* perf_create(){ return nullptr; }
+unsigned perf_opened(PerfHandle*) { return 0; }
 void perf_reset(PerfHandle*) {}
 void perf_enable(PerfHandle*) {}
 void perf_disable(PerfHandle*) {}
@@ -0,0 +1,262 @@
+#include "runner.hpp"
+#include "utils.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+int compact_score(double throughput) {
+    if (throughput <= 0.0) return 0;
+    double v = 1000.0 * std::log10(throughput + 1.0);
+    return static_cast<int>(std::round(v));
+}
+
+bool valid_placement(const std::string& placement) {
+    return placement == "none" || placement == "compact" || placement == "spread";
+}
+
+static int placement_cpu(const std::string& placement, const std::vector<int>& cpus, int t, int threads) {
+    if (cpus.empty() || placement == "none") return -1;
+    size_t n = cpus.size();
+    if (placement == "spread" && threads > 0) return cpus[(static_cast<size_t>(t) * n / threads) % n];
+    return cpus[static_cast<size_t>(t) % n];
+}
+
+RunResult run_workload(Workload& workload, const RunConfig& cfg, bool show_progress,
+                       const std::function<void(const IntervalSample&)>& on_interval) {
+    RunResult result;
+    int duration_seconds = cfg.duration_seconds;
+
+    auto start_time = std::chrono::steady_clock::now();
+    auto end_time = start_time + std::chrono::seconds(duration_seconds);
+    std::atomic<uint64_t> total_batches{0};
+    std::mutex samples_mtx;
+    // First exception thrown by a worker; stops the run and is rethrown after join.
+    std::atomic<bool> failed{false};
+    std::exception_ptr first_error;
+
+    std::vector<int> cpus = cfg.placement == "none" ? std::vector<int>() : allowed_cpus();
+
+    std::vector<std::thread> thread_pool;
+    for (int t = 0; t < cfg.threads; ++t) {
+        int cpu = placement_cpu(cfg.placement, cpus, t, cfg.threads);
+        thread_pool.emplace_back([&, cpu]() {
+            if (cpu >= 0) pin_current_thread(cpu);
+            try {
+                while (!failed.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < end_time) {
+                    auto s0 = std::chrono::steady_clock::now();
+                    workload.run_batch();
+                    auto s1 = std::chrono::steady_clock::now();
+                    double elapsed = std::chrono::duration<double, std::milli>(s1 - s0).count();
+                    uint64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(s1 - s0).count();
+                    {
+                        std::lock_guard<std::mutex> lk(samples_mtx);
+                        result.samples.push_back(elapsed);
+                        result.histogram.record(elapsed_ns);
+                    }
+                    total_batches++;
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(samples_mtx);
+                if (!first_error) first_error = std::current_exception();
+                failed = true;
+            }
+        });
+    }
+
+    double interval = cfg.interval_seconds > 0 ? cfg.interval_seconds : 1.0;
+    uint64_t interval_start_batches = 0;
+    double interval_start = 0.0;
+    auto close_interval = [&](double now_s) {
+        IntervalSample s;
+        s.index = static_cast<int>(result.intervals.size());
+        s.elapsed_seconds = now_s;
+        uint64_t batches = total_batches.load();
+        s.batches = batches - interval_start_batches;
+        s.throughput_batches_per_s = now_s > interval_start ? s.batches / (now_s - interval_start) : 0.0;
+        interval_start_batches = batches;
+        interval_start = now_s;
+        result.intervals.push_back(s);
+        if (on_interval) on_interval(s);
+    };
+
+    while (!failed && std::chrono::steady_clock::now() < end_time) {
+        auto now = std::chrono::steady_clock::now();
+        double elapsed_s = std::chrono::duration<double>(now - start_time).count();
+        if (elapsed_s >= interval_start + interval) close_interval(elapsed_s);
+        if (show_progress) {
+            double fraction = elapsed_s / duration_seconds;
+            int bar_width = 40;
+            if (fraction < 0) fraction = 0;
+            if (fraction > 1) fraction = 1;
+            int pos = static_cast<int>(bar_width * fraction);
+            std::cout << "[";
+            for (int i = 0; i < bar_width; ++i) {
+                if (i < pos) std::cout << "=";
+                else if (i == pos) std::cout << ">";
+                else std::cout << " ";
+            }
+            std::cout << "] " << int(fraction * 100.0) << "%\r";
+            std::cout.flush();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    for (auto &th : thread_pool) th.join();
+    if (first_error) std::rethrow_exception(first_error);
+    double finished_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (total_batches.load() > interval_start_batches) close_interval(finished_s);
+
+    // Workers finish the batch they are in after end_time, so domain counters
+    // cover the measured span, not the nominal duration.
+    workload.report(result.metrics, finished_s);
+
+    result.total_batches = total_batches.load();
+    result.stats = compute_stats(result.samples);
+    if (duration_seconds > 0) result.throughput = static_cast<double>(result.total_batches) / duration_seconds;
+    result.score = compact_score(result.throughput);
+    return result;
+}
+
+void print_result(const RunConfig& cfg, const RunResult& r) {
+    const Stats& st = r.stats;
+    std::cout << "Workload: " << cfg.workload << std::endl;
+    std::cout << "CPU Threads: " << cfg.threads << std::endl;
+    std::cout << "Total Time: " << cfg.duration_seconds << "s" << std::endl;
+    std::cout << "Total Batches: " << r.total_batches << std::endl;
+    if (r.metrics.contains("throughput_unit")) {
+        std::cout << "Throughput (" << r.metrics["throughput_unit"].get<std::string>() << "): " << std::fixed << std::setprecision(3) << r.metrics["throughput"].get<double>() << std::endl;
+    }
+    std::cout << "Throughput (batches/s): " << std::fixed << std::setprecision(3) << r.throughput << std::endl;
+    std::cout << "Score: " << r.score << " (compact)" << std::endl;
+    std::cout << "Sample mean (ms): " << st.mean << " median: " << st.median << " stddev: " << st.stddev << "\n";
+    auto pct = [&](int p) { auto it = st.percentiles.find(p); return it == st.percentiles.end() ? 0.0 : it->second; };
+    std::cout << "min: " << st.min << " max: " << st.max << " p90: " << pct(90) << " p99: " << pct(99) << "\n";
+    for (auto &m : r.metrics.items()) {
+        if (!m.value().is_array()) {
+            std::cout << m.key() << ": " << m.value().dump() << "\n";
+            continue;
+        }
+        // Tables (per-CPU rows, worst-N lists): one row per line, nested detail left to the JSON output.
+        std::cout << m.key() << ":\n";
+        for (auto &row : m.value()) {
+            nlohmann::json flat = row;
+            if (row.is_object()) {
+                for (auto &f : row.items()) if (f.value().is_structured()) flat.erase(f.key());
+            }
+            std::cout << "  " << flat.dump() << "\n";
+        }
+    }
+}
+
+nlohmann::json result_to_json(const RunConfig& cfg, const RunResult& r) {
+    const Stats& st = r.stats;
+    nlohmann::json jout;
+    jout["workload"] = cfg.workload;
+    jout["threads"] = cfg.threads;
+    jout["duration_seconds"] = cfg.duration_seconds;
+    if (cfg.placement != "none") jout["placement"] = cfg.placement;
+    jout["total_batches"] = r.total_batches;
+    jout["throughput_batches_per_s"] = r.throughput;
+    jout["score"] = r.score;
+    nlohmann::json jstats;
+    jstats["mean_ms"] = st.mean;
+    jstats["median_ms"] = st.median;
+    jstats["stddev_ms"] = st.stddev;
+    jstats["min_ms"] = st.min;
+    jstats["max_ms"] = st.max;
+    nlohmann::json jperc;
+    for (auto &p : st.percentiles) jperc[std::to_string(p.first)] = p.second;
+    jstats["percentiles"] = jperc;
+    jout["stats"] = jstats;
+
+    nlohmann::json jhist = nlohmann::json::array();
+    std::vector<int> hist_bins(10, 0);
+    if (!r.samples.empty()) {
+        double minv = st.min;
+        double maxv = st.max;
+        double range = maxv - minv;
+        if (range <= 0) hist_bins[0] = r.samples.size();
+        else {
+            for (double v : r.samples) {
+                int bin = static_cast<int>((v - minv) / range * (hist_bins.size() - 1));
+                if (bin < 0) bin = 0;
+                if (bin >= (int)hist_bins.size()) bin = hist_bins.size() - 1;
+                hist_bins[bin]++;
+            }
+        }
+    }
+    for (int c : hist_bins) jhist.push_back(c);
+    jout["histogram_bins"] = jhist;
+    jout["latency_histogram"] = histogram_to_json(r.histogram);
+
+    nlohmann::json jint = nlohmann::json::array();
+    for (auto &s : r.intervals) {
+        jint.push_back({{"index", s.index}, {"elapsed_seconds", s.elapsed_seconds},
+                        {"batches", s.batches}, {"throughput_batches_per_s", s.throughput_batches_per_s}});
+    }
+    jout["intervals"] = jint;
+    if (!cfg.params.empty()) jout["params"] = cfg.params;
+    if (!r.metrics.empty()) jout["metrics"] = r.metrics;
+    return jout;
+}
+
+// Sparse [[bucket, count], ...] encoding of the per-batch latency histogram (ns).
+nlohmann::json histogram_to_json(const LatencyHistogram& h) {
+    nlohmann::json j;
+    j["unit"] = "ns";
+    j["sub_bits"] = LatencyHistogram::kSubBits;
+    j["count"] = h.count();
+    j["min"] = h.min();
+    j["max"] = h.max();
+    nlohmann::json buckets = nlohmann::json::array();
+    const auto& counts = h.buckets();
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i]) buckets.push_back({i, counts[i]});
+    }
+    j["buckets"] = buckets;
+    return j;
+}
+
+LatencyHistogram histogram_from_json(const nlohmann::json& j) {
+    LatencyHistogram h;
+    if (j.value("sub_bits", LatencyHistogram::kSubBits) != LatencyHistogram::kSubBits) return h;
+    if (!j.contains("buckets")) return h;
+    for (auto &b : j["buckets"]) h.add_bucket(b.at(0).get<size_t>(), b.at(1).get<uint64_t>());
+    if (j.contains("min") && j.contains("max")) h.set_bounds(j["min"].get<uint64_t>(), j["max"].get<uint64_t>());
+    return h;
+}
+
+void apply_run_config(const nlohmann::json& j, RunConfig& cfg) {
+    if (j.contains("duration")) cfg.duration_seconds = j["duration"].get<int>();
+    if (j.contains("threads")) cfg.threads = j["threads"].get<int>();
+    if (j.contains("workset_bytes")) cfg.workset_bytes = j["workset_bytes"].get<size_t>();
+    if (j.contains("workload")) cfg.workload = j["workload"].get<std::string>();
+    if (j.contains("interval")) cfg.interval_seconds = j["interval"].get<double>();
+    if (j.contains("placement")) {
+        cfg.placement = j["placement"].get<std::string>();
+        if (!valid_placement(cfg.placement)) throw std::invalid_argument("unknown placement '" + cfg.placement + "'");
+    }
+    if (j.contains("params")) {
+        for (auto &kv : j["params"].items()) {
+            cfg.params[kv.key()] = kv.value().is_string() ? kv.value().get<std::string>() : kv.value().dump();
+        }
+    }
+}
+
+nlohmann::json run_config_to_json(const RunConfig& cfg) {
+    nlohmann::json j;
+    j["workload"] = cfg.workload;
+    j["duration"] = cfg.duration_seconds;
+    j["threads"] = cfg.threads;
+    j["workset_bytes"] = cfg.workset_bytes;
+    j["interval"] = cfg.interval_seconds;
+    j["placement"] = cfg.placement;
+    j["params"] = cfg.params;
+    return j;
+}
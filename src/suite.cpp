@@ -0,0 +1,269 @@
+#include "suite.hpp"
+#include "workload_registry.hpp"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Outer to inner, so runs that can share a workset end up adjacent.
+const char* const kAxes[] = {"workload", "workset_bytes", "threads", "placement"};
+
+std::vector<nlohmann::json> axis_values(const nlohmann::json& stage, const char* key) {
+    if (!stage.contains(key)) return {nlohmann::json()};
+    const auto& v = stage[key];
+    if (!v.is_array()) return {v};
+    if (v.empty()) throw std::invalid_argument(std::string("'") + key + "' must not be an empty list");
+    return std::vector<nlohmann::json>(v.begin(), v.end());
+}
+
+void expand_stage(const nlohmann::json& stage, const RunConfig& defaults, const std::string& name,
+                  std::vector<SuiteRun>& out) {
+    // A list-valued workload parameter is one more axis. These go right after
+    // "workload": the instance is keyed on its parameters, so holding them
+    // fixed across the inner axes keeps the workset reusable.
+    std::vector<std::string> keys = {kAxes[0]};
+    std::vector<bool> is_param = {false};
+    if (stage.contains("params") && stage["params"].is_object()) {
+        for (auto& kv : stage["params"].items()) {
+            if (!kv.value().is_array()) continue;
+            keys.push_back(kv.key());
+            is_param.push_back(true);
+        }
+    }
+    for (size_t a = 1; a < sizeof(kAxes) / sizeof(kAxes[0]); ++a) {
+        keys.push_back(kAxes[a]);
+        is_param.push_back(false);
+    }
+
+    std::vector<std::vector<nlohmann::json>> axes;
+    for (size_t a = 0; a < keys.size(); ++a) {
+        const nlohmann::json& src = is_param[a] ? stage["params"] : stage;
+        axes.push_back(axis_values(src, keys[a].c_str()));
+    }
+
+    std::vector<size_t> pos(axes.size(), 0);
+    for (;;) {
+        nlohmann::json j = stage;
+        for (size_t a = 0; a < axes.size(); ++a) {
+            nlohmann::json& dst = is_param[a] ? j["params"] : j;
+            if (axes[a][pos[a]].is_null()) dst.erase(keys[a]);
+            else dst[keys[a]] = axes[a][pos[a]];
+        }
+        SuiteRun run;
+        run.stage = name;
+        run.cfg = defaults;
+        apply_run_config(j, run.cfg);
+        if (run.cfg.threads <= 0) throw std::invalid_argument("stage '" + name + "': threads must be > 0");
+        if (run.cfg.duration_seconds <= 0) throw std::invalid_argument("stage '" + name + "': duration must be > 0");
+        out.push_back(run);
+
+        size_t a = axes.size();
+        while (a > 0) {
+            --a;
+            if (++pos[a] < axes[a].size()) break;
+            pos[a] = 0;
+            if (a == 0) return;
+        }
+    }
+}
+
+} // namespace
+
+std::vector<SuiteRun> expand_suite(const nlohmann::json& suite, const RunConfig& defaults) {
+    if (!suite.is_object()) throw std::invalid_argument("suite must be a JSON object");
+    std::vector<SuiteRun> runs;
+
+    nlohmann::json top = suite;
+    top.erase("stages");
+    top.erase("name");
+    top.erase("output");
+    if (!suite.contains("stages")) {
+        expand_stage(top, defaults, suite.value("name", "default"), runs);
+        return runs;
+    }
+    if (!suite["stages"].is_array()) throw std::invalid_argument("'stages' must be a list");
+
+    int index = 0;
+    for (const auto& stage : suite["stages"]) {
+        if (!stage.is_object()) throw std::invalid_argument("every stage must be a JSON object");
+        nlohmann::json merged = top;
+        for (auto& kv : stage.items()) {
+            if (kv.key() == "params" && merged.contains("params")) merged["params"].update(kv.value());
+            else merged[kv.key()] = kv.value();
+        }
+        std::string name = stage.value("name", "stage" + std::to_string(index));
+        merged.erase("name");
+        expand_stage(merged, defaults, name, runs);
+        ++index;
+    }
+    return runs;
+}
+
+int run_suite(const std::string& path, const RunConfig& defaults, const std::string& out_file) {
+    nlohmann::json suite;
+    std::vector<SuiteRun> runs;
+    try {
+        std::ifstream ifs(path);
+        if (!ifs) {
+            std::cerr << "Failed to open suite file: " << path << std::endl;
+            return 1;
+        }
+        ifs >> suite;
+        runs = expand_suite(suite, defaults);
+    } catch (std::exception& e) {
+        std::cerr << "Failed to parse suite file: " << e.what() << std::endl;
+        return 1;
+    }
+    if (runs.empty()) {
+        std::cerr << "Suite " << path << " has no runs" << std::endl;
+        return 1;
+    }
+
+    // Reject unknown workloads and bad parameters before spending time on any run.
+    auto& reg = WorkloadRegistry::instance();
+    for (auto& run : runs) {
+        auto w = reg.create(run.cfg.workload);
+        if (!w) {
+            std::cerr << "Stage '" << run.stage << "': unknown workload '" << run.cfg.workload << "'" << std::endl;
+            return 1;
+        }
+        try {
+            w->configure(run.cfg.params);
+        } catch (std::exception& e) {
+            std::cerr << "Stage '" << run.stage << "': invalid parameters for '" << run.cfg.workload << "': " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::string output = out_file.empty() ? suite.value("output", "") : out_file;
+    auto suite_start = std::chrono::steady_clock::now();
+    double setup_total = 0.0, measured_total = 0.0;
+    int reused_count = 0;
+
+    std::unique_ptr<Workload> live;
+    std::string live_key;
+    nlohmann::json jruns = nlohmann::json::array();
+    int failed_count = 0;
+    // A failed run is recorded and the suite moves on; the instance it was
+    // using is dropped, since its state is unknown.
+    auto record_failure = [&](size_t i, const char* phase, const std::string& what) {
+        const RunConfig& cfg = runs[i].cfg;
+        std::cerr << "[" << (i + 1) << "/" << runs.size() << "] " << runs[i].stage << ": '" << cfg.workload
+                  << "' failed during " << phase << ": " << what << std::endl;
+        if (live) {
+            try { live->shutdown(); } catch (std::exception&) {}
+        }
+        live.reset();
+        live_key.clear();
+        nlohmann::json j = run_config_to_json(cfg);
+        j["stage"] = runs[i].stage;
+        j["run_index"] = i;
+        j["workset_bytes"] = cfg.workset_bytes;
+        j["error"] = std::string(phase) + ": " + what;
+        jruns.push_back(j);
+        ++failed_count;
+    };
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const RunConfig& cfg = runs[i].cfg;
+        std::string key = cfg.workload + "|" + nlohmann::json(cfg.params).dump();
+
+        auto t0 = std::chrono::steady_clock::now();
+        bool reused = false;
+        RunResult r;
+        try {
+            reused = live && live_key == key && live->reuse(cfg.threads, cfg.workset_bytes);
+            if (!reused) {
+                if (live) live->shutdown();
+                live.reset();
+                live = reg.create(cfg.workload);
+                live->configure(cfg.params);
+                live->init(cfg.threads, cfg.workset_bytes);
+                live_key = key;
+            }
+        } catch (std::exception& e) {
+            record_failure(i, "setup", e.what());
+            continue;
+        }
+        double setup_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        setup_total += setup_s;
+        if (reused) ++reused_count;
+
+        std::cout << "[" << (i + 1) << "/" << runs.size() << "] " << runs[i].stage << ": '" << cfg.workload
+                  << "' threads=" << cfg.threads << " workset=" << cfg.workset_bytes << " placement=" << cfg.placement
+                  << (cfg.params.empty() ? "" : " params=" + nlohmann::json(cfg.params).dump())
+                  << (reused ? " (workset reused)" : "") << std::endl;
+
+        auto m0 = std::chrono::steady_clock::now();
+        try {
+            r = run_workload(*live, cfg, true);
+        } catch (std::exception& e) {
+            std::cout << std::endl;
+            record_failure(i, "run", e.what());
+            continue;
+        }
+        measured_total += std::chrono::duration<double>(std::chrono::steady_clock::now() - m0).count();
+        std::cout << std::endl;
+
+        nlohmann::json j = result_to_json(cfg, r);
+        j["stage"] = runs[i].stage;
+        j["run_index"] = i;
+        j["placement"] = cfg.placement;
+        j["workset_bytes"] = cfg.workset_bytes;
+        j["reused_workset"] = reused;
+        j["setup_seconds"] = setup_s;
+        jruns.push_back(j);
+    }
+    if (live) live->shutdown();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - suite_start).count();
+
+    std::cout << "===== Suite Complete =====" << std::endl;
+    std::cout << std::left << std::setw(16) << "stage" << std::setw(12) << "workload" << std::setw(9) << "threads"
+              << std::setw(12) << "workset" << std::setw(10) << "placement" << std::right << std::setw(16) << "batches/s"
+              << std::setw(24) << "domain" << "  params" << std::endl;
+    for (auto& j : jruns) {
+        if (j.contains("error")) {
+            std::cout << std::left << std::setw(16) << j["stage"].get<std::string>() << std::setw(12) << j["workload"].get<std::string>()
+                      << std::setw(9) << j["threads"].get<int>() << std::setw(12) << j["workset_bytes"].get<size_t>()
+                      << std::setw(10) << j["placement"].get<std::string>() << std::right << std::setw(16) << "FAILED"
+                      << "  " << j["error"].get<std::string>() << std::endl;
+            continue;
+        }
+        std::string domain;
+        if (j.contains("metrics") && j["metrics"].contains("throughput_unit")) {
+            std::ostringstream os;
+            os << std::setprecision(4) << j["metrics"]["throughput"].get<double>() << " " << j["metrics"]["throughput_unit"].get<std::string>();
+            domain = os.str();
+        }
+        std::cout << std::left << std::setw(16) << j["stage"].get<std::string>() << std::setw(12) << j["workload"].get<std::string>()
+                  << std::setw(9) << j["threads"].get<int>() << std::setw(12) << j["workset_bytes"].get<size_t>()
+                  << std::setw(10) << j["placement"].get<std::string>() << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(16) << j["throughput_batches_per_s"].get<double>() << std::setw(24) << domain << "  " << (j.contains("params") ? j["params"].dump() : "") << std::endl;
+    }
+    std::cout << "Runs: " << jruns.size() << " (" << reused_count << " reused a workset, " << failed_count << " failed)"
+              << " wall: " << wall << "s measured: " << measured_total << "s setup: " << setup_total << "s" << std::endl;
+
+    if (!output.empty()) {
+        nlohmann::json report;
+        report["suite"] = suite.value("name", path);
+        report["run_count"] = jruns.size();
+        report["reused_worksets"] = reused_count;
+        report["failed_runs"] = failed_count;
+        report["wall_seconds"] = wall;
+        report["measured_seconds"] = measured_total;
+        report["setup_seconds"] = setup_total;
+        report["runs"] = jruns;
+        std::ofstream ofs(output);
+        if (!ofs) {
+            std::cerr << "Failed to open output file for writing: " << output << std::endl;
+            return 1;
+        }
+        ofs << report.dump(2) << std::endl;
+        std::cout << "Wrote results to " << output << "\n";
+    }
+    return failed_count ? 1 : 0;
+}
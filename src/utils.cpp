@@ -4,6 +4,13 @@
 #include <iostream>
 #include <cstdio>
 #include <thread>
+#include <fstream>
+#include <string>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#endif
 
 double run_command(const std::string& cmd) {
     auto start = std::chrono::high_resolution_clock::now();
@@ -45,3 +52,56 @@ void print_results(const std::string& cmd, const std::vector<double>& times) {
     std::cout << "Median: " << med << "s\n";
     std::cout << "Stddev: " << sd << "s\n";
 }
+
+long peak_rss_kb() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return std::stol(line.substr(6));
+    }
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0) return ru.ru_maxrss;
+#endif
+    return 0;
+}
+
+void reset_peak_rss() {
+#ifdef __linux__
+    std::ofstream ofs("/proc/self/clear_refs");
+    if (ofs) ofs << "5";
+#endif
+}
+
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) if (CPU_ISSET(c, &set)) cpus.push_back(c);
+    }
+#endif
+    return cpus;
+}
+
+bool pin_current_thread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+int current_cpu() {
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
@@ -1,5 +1,8 @@
 #include "workload.hpp"
 #include "workload_registry.hpp"
+#include "workloads.hpp"
+#include <atomic>
+#include <cctype>
 #include <cmath>
 #include <memory>
 #include <thread>
@@ -7,6 +10,98 @@
 #include <cstring>
 #include <fstream>
 #include <vector>
+#include <stdexcept>
+
+namespace {
+
+// Generations are unique across all ThreadSlots, so a cache entry can never
+// match a different instance that happens to reuse the same address.
+std::atomic<uint64_t> g_slot_generation{1};
+
+struct SlotCache {
+    const ThreadSlots* owner = nullptr;
+    uint64_t generation = 0;
+    int slot = 0;
+};
+thread_local SlotCache t_slot_cache;
+
+} // namespace
+
+ThreadSlots::ThreadSlots() : generation_(g_slot_generation.fetch_add(1)) {}
+
+void ThreadSlots::reset(int n) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    ids_.clear();
+    n_ = n > 0 ? n : 1;
+    generation_.store(g_slot_generation.fetch_add(1));
+}
+
+int ThreadSlots::current() {
+    uint64_t gen = generation_.load(std::memory_order_acquire);
+    SlotCache& c = t_slot_cache;
+    if (c.owner == this && c.generation == gen) return c.slot;
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto id = std::this_thread::get_id();
+    auto it = ids_.find(id);
+    int slot;
+    if (it != ids_.end()) {
+        slot = it->second;
+    } else {
+        slot = static_cast<int>(ids_.size()) % n_;
+        ids_.emplace(id, slot);
+    }
+    c.owner = this;
+    c.generation = generation_.load(std::memory_order_relaxed);
+    c.slot = slot;
+    return slot;
+}
+
+std::string param_string(const WorkloadParams& p, const std::string& key, const std::string& def) {
+    auto it = p.find(key);
+    return it == p.end() ? def : it->second;
+}
+
+double param_double(const WorkloadParams& p, const std::string& key, double def) {
+    auto it = p.find(key);
+    if (it == p.end()) return def;
+    // std::stod accepts "nan"/"inf" (which slip past range checks written as
+    // x < lo || x > hi) and ignores trailing characters; reject both.
+    const std::string& v = it->second;
+    size_t pos = 0;
+    double value = 0;
+    bool ok = true;
+    try {
+        value = std::stod(v, &pos);
+    } catch (std::exception&) {
+        ok = false;
+    }
+    if (!ok || pos != v.size() || !std::isfinite(value))
+        throw std::invalid_argument("parameter '" + key + "' expects a finite number, got '" + v + "'");
+    return value;
+}
+
+uint64_t param_u64(const WorkloadParams& p, const std::string& key, uint64_t def) {
+    auto it = p.find(key);
+    if (it == p.end()) return def;
+    // std::stoull wraps a leading '-' around to a huge value, so reject signs
+    // and anything left over after the digits.
+    const std::string& v = it->second;
+    size_t first = v.find_first_not_of(" \t");
+    bool ok = first != std::string::npos && std::isdigit(static_cast<unsigned char>(v[first]));
+    size_t pos = 0;
+    uint64_t value = 0;
+    if (ok) {
+        try {
+            value = std::stoull(v, &pos);
+        } catch (std::exception&) {
+            ok = false;
+        }
+    }
+    if (!ok || pos != v.size())
+        throw std::invalid_argument("parameter '" + key + "' expects a non-negative integer, got '" + v + "'");
+    return value;
+}
 
 void SIMDWorkload::init(int threads, size_t workset_bytes_) {
 
@@ -32,6 +127,12 @@ std::string SIMDWorkload::name() const {
     return "simd";
 }
 
+bool SIMDWorkload::reuse(int /*threads*/, size_t workset_bytes_) {
+    if (data.size() != workset_bytes_ / sizeof(float)) return false;
+    s = 0;
+    return true;
+}
+
 
 void register_builtin_workloads() {
     auto &reg = WorkloadRegistry::instance();
@@ -55,6 +156,11 @@ void register_builtin_workloads() {
             }
             void shutdown() override { buf.clear(); tmp.clear(); }
             std::string name() const override { return "memcpy"; }
+            bool reuse(int /*threads*/, size_t workset_bytes) override {
+                if (buf.size() != workset_bytes / 2) return false;
+                counter = 0;
+                return true;
+            }
         private:
             std::vector<char> buf;
             std::vector<char> tmp;
@@ -84,10 +190,16 @@ void register_builtin_workloads() {
             }
             void shutdown() override { /* leave file for inspection */ }
             std::string name() const override { return "io"; }
+            bool reuse(int /*threads*/, size_t /*workset_bytes*/) override { counter = 0; return true; }
         private:
             std::string path;
             uint64_t counter = 0;
         };
         return std::make_unique<IOWorkload>();
     });
+
+    register_alloc_workloads();
+    register_kernel_workloads();
+    register_jitter_workloads();
+    register_branch_workloads();
 }
@@ -0,0 +1,89 @@
+#include <catch2/catch.hpp>
+#include "cluster.hpp"
+#include "histogram.hpp"
+
+namespace {
+
+nlohmann::json host_result(const std::string& agent, double throughput, uint64_t latency_ns, int intervals) {
+    LatencyHistogram h;
+    for (int i = 0; i < 100; ++i) h.record(latency_ns);
+    nlohmann::json r;
+    r["total_batches"] = static_cast<uint64_t>(throughput * 10);
+    r["throughput_batches_per_s"] = throughput;
+    r["latency_histogram"] = histogram_to_json(h);
+    r["metrics"] = {{"throughput", throughput * 1000}, {"throughput_unit", "keys/s"}};
+    nlohmann::json jint = nlohmann::json::array();
+    for (int i = 0; i < intervals; ++i) jint.push_back({{"index", i}, {"throughput_batches_per_s", throughput}});
+    r["intervals"] = jint;
+    return {{"agent", agent}, {"hostname", agent}, {"result", r}};
+}
+
+const nlohmann::json& host(const nlohmann::json& report, const std::string& agent) {
+    for (auto& h : report["hosts"]) {
+        if (h["agent"] == agent) return h;
+    }
+    FAIL("no host " << agent);
+    return report;
+}
+
+} // namespace
+
+TEST_CASE("aggregate sums hosts and keeps only intervals every host reported") {
+    RunConfig cfg;
+    cfg.threads = 4;
+    std::vector<nlohmann::json> hosts = {
+        host_result("a", 100.0, 1000000, 3),
+        host_result("b", 104.0, 1000000, 3),
+        host_result("c", 98.0, 1000000, 2),
+    };
+    nlohmann::json r = aggregate_host_results(hosts, cfg, 0.10);
+
+    REQUIRE(r["agents"] == 3);
+    REQUIRE(r["threads_per_agent"] == 4);
+    REQUIRE(r["total_batches"].get<uint64_t>() == 3020);
+    REQUIRE(r["throughput_batches_per_s"].get<double>() == Approx(302.0));
+    REQUIRE(r["metrics"]["throughput"].get<double>() == Approx(302000.0));
+    REQUIRE(r["metrics"]["throughput_unit"] == "keys/s");
+    REQUIRE(r["latency_histogram"]["count"] == 300);
+    REQUIRE(r["stats"]["min_ms"].get<double>() == Approx(1.0));
+    REQUIRE(r["stats"]["max_ms"].get<double>() == Approx(1.0));
+
+    REQUIRE(r["intervals"].size() == 2);
+    REQUIRE(r["intervals"][1]["throughput_batches_per_s"].get<double>() == Approx(302.0));
+    REQUIRE(r["outliers"].empty());
+}
+
+TEST_CASE("aggregate flags hosts on either side of the median") {
+    RunConfig cfg;
+    cfg.threads = 0;
+
+    SECTION("slow host") {
+        nlohmann::json r = aggregate_host_results(
+            {host_result("a", 100.0, 1000000, 1), host_result("b", 105.0, 1000000, 1), host_result("slow", 80.0, 1000000, 1)},
+            cfg, 0.10);
+        REQUIRE_FALSE(r.contains("threads_per_agent"));
+        REQUIRE(r["median_host_throughput_batches_per_s"].get<double>() == Approx(100.0));
+        REQUIRE(r["outliers"] == nlohmann::json::array({"slow"}));
+        REQUIRE(host(r, "slow")["throughput_outlier"] == true);
+        REQUIRE(host(r, "slow")["throughput_deviation"].get<double>() == Approx(-0.2));
+        REQUIRE(host(r, "b")["outlier"] == false);
+    }
+
+    SECTION("fast host is flagged as well") {
+        nlohmann::json r = aggregate_host_results(
+            {host_result("a", 100.0, 1000000, 1), host_result("b", 95.0, 1000000, 1), host_result("fast", 120.0, 1000000, 1)},
+            cfg, 0.10);
+        REQUIRE(r["outliers"] == nlohmann::json::array({"fast"}));
+        REQUIRE(host(r, "fast")["throughput_deviation"].get<double>() == Approx(0.2));
+    }
+
+    SECTION("slow p99 is a latency outlier, fast p99 is not") {
+        nlohmann::json r = aggregate_host_results(
+            {host_result("a", 100.0, 1000000, 1), host_result("laggy", 100.0, 2000000, 1), host_result("quick", 100.0, 500000, 1)},
+            cfg, 0.10);
+        REQUIRE(r["outliers"] == nlohmann::json::array({"laggy"}));
+        REQUIRE(host(r, "laggy")["latency_outlier"] == true);
+        REQUIRE(host(r, "quick")["latency_outlier"] == false);
+        REQUIRE(host(r, "quick")["throughput_outlier"] == false);
+    }
+}
@@ -0,0 +1,41 @@
+#include <catch2/catch.hpp>
+#include "histogram.hpp"
+
+TEST_CASE("histogram bucket bounds contain their values") {
+    for (uint64_t v : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, 18446744073709551615ull}) {
+        size_t idx = LatencyHistogram::bucket_index(v);
+        REQUIRE(LatencyHistogram::bucket_lower(idx) <= v);
+        REQUIRE(LatencyHistogram::bucket_upper(idx) >= v);
+    }
+}
+
+TEST_CASE("histogram percentiles and merge") {
+    LatencyHistogram a, b, all;
+    for (uint64_t i = 1; i <= 1000; ++i) { a.record(i * 1000); all.record(i * 1000); }
+    for (uint64_t i = 1001; i <= 2000; ++i) { b.record(i * 1000); all.record(i * 1000); }
+
+    REQUIRE(a.percentile(50) == Approx(500000.0).epsilon(0.04));
+    REQUIRE(a.min() == 1000);
+    REQUIRE(a.max() == 1000000);
+
+    a.merge(b);
+    REQUIRE(a.count() == 2000);
+    REQUIRE(a.buckets() == all.buckets());
+    REQUIRE(a.mean() == Approx(all.mean()));
+    REQUIRE(a.percentile(99) == Approx(1980000.0).epsilon(0.04));
+}
+
+TEST_CASE("histogram rebuilt from buckets keeps percentiles") {
+    LatencyHistogram h, copy;
+    for (uint64_t i = 0; i < 5000; ++i) h.record(50000 + i * 37);
+    for (size_t i = 0; i < h.buckets().size(); ++i) copy.add_bucket(i, h.buckets()[i]);
+    REQUIRE(copy.count() == h.count());
+    REQUIRE(copy.percentile(90) == Approx(h.percentile(90)).epsilon(0.04));
+
+    REQUIRE(copy.min() <= h.min());
+    REQUIRE(copy.max() >= h.max());
+    copy.set_bounds(h.min(), h.max());
+    REQUIRE(copy.min() == h.min());
+    REQUIRE(copy.max() == h.max());
+    REQUIRE(copy.percentile(100) == Approx(static_cast<double>(h.max())));
+}
@@ -0,0 +1,59 @@
+#include <catch2/catch.hpp>
+#include "suite.hpp"
+
+TEST_CASE("suite expands stages in reuse-friendly order") {
+    nlohmann::json doc = nlohmann::json::parse(R"({
+        "name": "t",
+        "duration": 3,
+        "workset_bytes": 4096,
+        "params": {"mode": "probe", "load_factor": 0.5},
+        "stages": [
+            {"name": "scale", "workload": "hashtable", "threads": [1, 2], "placement": ["compact", "spread"],
+             "params": {"load_factor": 0.7}},
+            {"name": "sweep", "workload": "branch", "workset_bytes": [1024, 2048],
+             "params": {"pattern": "random", "p": [0.5, 0.9]}}
+        ]
+    })");
+    RunConfig defaults;
+    defaults.interval_seconds = 2.0;
+    auto runs = expand_suite(doc, defaults);
+    REQUIRE(runs.size() == 8);
+
+    // Stage 1: threads outside placement; stage params merged over top-level params.
+    const std::pair<int, const char*> shape[] = {{1, "compact"}, {1, "spread"}, {2, "compact"}, {2, "spread"}};
+    for (int i = 0; i < 4; ++i) {
+        const RunConfig& c = runs[i].cfg;
+        REQUIRE(runs[i].stage == "scale");
+        REQUIRE(c.workload == "hashtable");
+        REQUIRE(c.threads == shape[i].first);
+        REQUIRE(c.placement == shape[i].second);
+        REQUIRE(c.duration_seconds == 3);
+        REQUIRE(c.workset_bytes == 4096);
+        REQUIRE(c.interval_seconds == 2.0);
+        REQUIRE(c.params.at("mode") == "probe");
+        REQUIRE(c.params.at("load_factor") == "0.7");
+    }
+
+    // Stage 2: a list-valued param is an axis outside workset_bytes, so runs
+    // with identical params (and so a reusable instance) stay adjacent.
+    const std::pair<const char*, size_t> sweep[] = {{"0.5", 1024}, {"0.5", 2048}, {"0.9", 1024}, {"0.9", 2048}};
+    for (int i = 0; i < 4; ++i) {
+        const RunConfig& c = runs[4 + i].cfg;
+        REQUIRE(runs[4 + i].stage == "sweep");
+        REQUIRE(c.workload == "branch");
+        REQUIRE(c.params.at("p") == sweep[i].first);
+        REQUIRE(c.workset_bytes == sweep[i].second);
+        REQUIRE(c.params.at("pattern") == "random");
+        REQUIRE(c.params.at("mode") == "probe");
+        REQUIRE(c.threads == defaults.threads);
+    }
+}
+
+TEST_CASE("suite rejects malformed documents") {
+    RunConfig defaults;
+    REQUIRE_THROWS_AS(expand_suite(nlohmann::json::parse(R"({"threads": []})"), defaults), std::invalid_argument);
+    REQUIRE_THROWS_AS(expand_suite(nlohmann::json::parse(R"({"params": {"p": []}})"), defaults), std::invalid_argument);
+    REQUIRE_THROWS_AS(expand_suite(nlohmann::json::parse(R"({"stages": {}})"), defaults), std::invalid_argument);
+    REQUIRE_THROWS_AS(expand_suite(nlohmann::json::parse(R"({"threads": 0})"), defaults), std::invalid_argument);
+    REQUIRE(expand_suite(nlohmann::json::parse(R"({"workload": "simd"})"), defaults).size() == 1);
+}